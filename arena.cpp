@@ -0,0 +1,41 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#include "arena.hpp"
+
+thread_local Arena* Arena::current = nullptr;
+
+Arena::Arena()
+  : buffer(4096), pool(&buffer), is_owner(current == nullptr)
+{
+  if (is_owner) {
+    current = this;
+  }
+}
+
+Arena::~Arena()
+{
+  if (is_owner) {
+    current = nullptr;
+  }
+}
+
+// Outside of any evaluation, allocations fall back to the global heap.
+Memory_resource* Arena::get_resource()
+{
+  return current != nullptr ? &current->pool : std::pmr::get_default_resource();
+}
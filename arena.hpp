@@ -0,0 +1,57 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <list>
+#include <memory_resource>
+#include <vector>
+
+class Arena;
+
+using Memory_resource = std::pmr::memory_resource;
+
+template<class T>
+using Arena_vector = std::pmr::vector<T>;
+
+template<class T>
+using Arena_list = std::pmr::list<T>;
+
+// An arena serves the allocations that never outlive the evaluation running on a thread: scopes, call stacks and the staging of
+// macro calls. The first arena created on a thread owns the memory, nested ones share it, and everything is released at once when
+// the owner goes, so that evaluation threads neither contend in the global heap for these nor free them one by one. Freed blocks
+// are pooled and reused meanwhile. Values are still allocated from the global heap, as they escape into modules, memos and outputs
+// shared between threads.
+class Arena {
+public:
+  Arena();
+  ~Arena();
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  static Memory_resource* get_resource();
+
+private:
+  std::pmr::monotonic_buffer_resource buffer;
+  std::pmr::unsynchronized_pool_resource pool;
+  bool is_owner;
+
+  static thread_local Arena* current;
+};
+
+#endif // ARENA_HPP
@@ -0,0 +1,248 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#include "bits.hpp"
+
+Bits::Bits(uint width)
+  : width(width), words((width + 63) / 64, 0)
+{
+}
+
+// The value is sign-extended to the width, like an integer literal assigned to a wider vector.
+Bits::Bits(uint width, int value)
+  : Bits(width)
+{
+  std::fill(words.begin(), words.end(), value < 0 ? ~0ULL : 0ULL);
+  if (!words.empty()) {
+    words[0] = (uint64_t)(int64_t)value;
+  }
+  clear_unused();
+}
+
+// The chunks are 32-bit words, the least significant first, as lists of integers used to model wide vectors.
+Bits::Bits(uint width, const Vector<int>& chunks)
+  : Bits(width)
+{
+  for (uint index = 0; index < chunks.size() && index / 2 < words.size(); index++) {
+    words[index / 2] |= (uint64_t)(uint)chunks[index] << (index % 2 * 32);
+  }
+  clear_unused();
+}
+
+uint Bits::get_width() const
+{
+  return width;
+}
+
+bool Bits::get_bit(uint index) const
+{
+  return (words[index / 64] >> (index % 64)) & 1;
+}
+
+bool Bits::is_zero() const
+{
+  return std::all_of(words.begin(), words.end(), [](uint64_t word) { return word == 0; });
+}
+
+Bits Bits::operator~() const
+{
+  Bits result(width);
+  uint size = words.size();
+  const uint64_t* items = words.data();
+  uint64_t* result_items = result.words.data();
+  for (uint index = 0; index < size; index++) {
+    result_items[index] = ~items[index];
+  }
+  result.clear_unused();
+  return result;
+}
+
+Bits Bits::operator&(const Bits& rhs) const
+{
+  return combine(rhs, [](uint64_t left, uint64_t right) { return left & right; });
+}
+
+Bits Bits::operator|(const Bits& rhs) const
+{
+  return combine(rhs, [](uint64_t left, uint64_t right) { return left | right; });
+}
+
+Bits Bits::operator^(const Bits& rhs) const
+{
+  return combine(rhs, [](uint64_t left, uint64_t right) { return left ^ right; });
+}
+
+// Shifts are logical, and keep the width.
+Bits Bits::operator<<(uint shift) const
+{
+  Bits result(width);
+  if (shift >= width) {
+    return result;
+  }
+  uint word_shift = shift / 64;
+  uint bit_shift = shift % 64;
+  for (uint index = word_shift; index < words.size(); index++) {
+    uint64_t word = words[index - word_shift] << bit_shift;
+    if (bit_shift != 0 && index > word_shift) {
+      word |= words[index - word_shift - 1] >> (64 - bit_shift);
+    }
+    result.words[index] = word;
+  }
+  result.clear_unused();
+  return result;
+}
+
+Bits Bits::operator>>(uint shift) const
+{
+  Bits result(width);
+  if (shift >= width) {
+    return result;
+  }
+  uint word_shift = shift / 64;
+  uint bit_shift = shift % 64;
+  for (uint index = 0; index + word_shift < words.size(); index++) {
+    uint64_t word = words[index + word_shift] >> bit_shift;
+    if (bit_shift != 0 && index + word_shift + 1 < words.size()) {
+      word |= words[index + word_shift + 1] << (64 - bit_shift);
+    }
+    result.words[index] = word;
+  }
+  return result;
+}
+
+bool Bits::operator==(const Bits& rhs) const
+{
+  return width == rhs.width && words == rhs.words;
+}
+
+// Truncates the vector, or extends it with zeros.
+Bits Bits::resize(uint width) const
+{
+  Bits result(width);
+  std::copy_n(words.begin(), std::min(words.size(), result.words.size()), result.words.begin());
+  result.clear_unused();
+  return result;
+}
+
+// The bounds are inclusive, and must lie within the width.
+Bits Bits::slice(uint high, uint low) const
+{
+  return (*this >> low).resize(high - low + 1);
+}
+
+// The vector ends up on the most significant side, like the first item of a Verilog concatenation.
+Bits Bits::concat(const Bits& rhs) const
+{
+  Bits result = resize(width + rhs.width) << rhs.width;
+  for (uint index = 0; index < rhs.words.size(); index++) {
+    result.words[index] |= rhs.words[index];
+  }
+  return result;
+}
+
+// Power-of-two bases print every digit of the width, decimal prints no leading zero.
+String Bits::to_string(int base) const
+{
+  if (base == 10) {
+    return to_decimal();
+  }
+  const char* digits = "0123456789abcdef";
+  uint digit_bits = base == 2 ? 1 : base == 8 ? 3 : 4;
+  uint count = (width + digit_bits - 1) / digit_bits;
+  String result(count, '0');
+  for (uint index = 0; index < count; index++) {
+    result[count - 1 - index] = digits[get_field(index * digit_bits, digit_bits)];
+  }
+  return result;
+}
+
+size_t Bits::hash() const
+{
+  size_t seed = std::hash<uint>()(width);
+  for (uint64_t word : words) {
+    seed ^= std::hash<uint64_t>()(word) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
+// The vectors are extended to the widest of both.
+template <class Operation>
+Bits Bits::combine(const Bits& rhs, Operation operation) const
+{
+  if (width != rhs.width) {
+    uint common_width = std::max(width, rhs.width);
+    return resize(common_width).combine(rhs.resize(common_width), operation);
+  }
+  Bits result(width);
+  uint size = words.size();
+  const uint64_t* left_items = words.data();
+  const uint64_t* right_items = rhs.words.data();
+  uint64_t* result_items = result.words.data();
+  for (uint index = 0; index < size; index++) {
+    result_items[index] = operation(left_items[index], right_items[index]);
+  }
+  return result;
+}
+
+// Reads up to four bits, which may straddle two words.
+uint Bits::get_field(uint low, uint count) const
+{
+  uint word_index = low / 64;
+  uint bit_index = low % 64;
+  uint64_t field = words[word_index] >> bit_index;
+  if (bit_index + count > 64 && word_index + 1 < words.size()) {
+    field |= words[word_index + 1] << (64 - bit_index);
+  }
+  return (uint)(field & ((1ULL << count) - 1));
+}
+
+// Divides the words by a billion until nothing is left, each division giving nine decimal digits. A word is divided in two
+// 32-bit halves, so that the partial dividends fit in 64 bits.
+String Bits::to_decimal() const
+{
+  const uint64_t billion = 1000000000;
+  Vector<uint64_t> value = words;
+  Vector<uint> chunks;
+  while (std::any_of(value.begin(), value.end(), [](uint64_t word) { return word != 0; })) {
+    uint64_t remainder = 0;
+    for (uint index = value.size(); index-- > 0;) {
+      uint64_t high = (remainder << 32) | (value[index] >> 32);
+      remainder = high % billion;
+      uint64_t low = (remainder << 32) | (value[index] & 0xffffffffULL);
+      remainder = low % billion;
+      value[index] = (high / billion) << 32 | (low / billion);
+    }
+    chunks.push_back((uint)remainder);
+  }
+  if (chunks.empty()) {
+    return "0";
+  }
+  String result = std::to_string(chunks.back());
+  for (uint index = chunks.size() - 1; index-- > 0;) {
+    String digits = std::to_string(chunks[index]);
+    result.append(9 - digits.size(), '0');
+    result += digits;
+  }
+  return result;
+}
+
+void Bits::clear_unused()
+{
+  if (width % 64 != 0) {
+    words.back() &= (1ULL << (width % 64)) - 1;
+  }
+}
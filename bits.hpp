@@ -0,0 +1,68 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#ifndef BITS_HPP
+#define BITS_HPP
+
+#include <algorithm>
+#include <cstdint>
+
+class Bits;
+
+#include "string.hpp"
+#include "utility.hpp"
+#include "vector.hpp"
+
+// A bit vector of any width, stored in 64-bit words from the least significant one. The bits above the width are kept cleared,
+// so that words can be compared and combined without masking. Operations run word by word, in loops the compiler vectorizes.
+class Bits {
+public:
+  explicit Bits(uint width);
+  Bits(uint width, int value);
+  Bits(uint width, const Vector<int>& chunks);
+
+  uint get_width() const;
+  bool get_bit(uint index) const;
+  bool is_zero() const;
+
+  Bits operator~() const;
+  Bits operator&(const Bits& rhs) const;
+  Bits operator|(const Bits& rhs) const;
+  Bits operator^(const Bits& rhs) const;
+  Bits operator<<(uint shift) const;
+  Bits operator>>(uint shift) const;
+  bool operator==(const Bits& rhs) const;
+
+  Bits resize(uint width) const;
+  Bits slice(uint high, uint low) const;
+  Bits concat(const Bits& rhs) const;
+
+  String to_string(int base) const;
+  size_t hash() const;
+
+private:
+  uint width;
+  Vector<uint64_t> words;
+
+  template <class Operation>
+  Bits combine(const Bits& rhs, Operation operation) const;
+  uint get_field(uint low, uint count) const;
+  String to_decimal() const;
+  void clear_unused();
+};
+
+#endif // BITS_HPP
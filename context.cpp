@@ -17,95 +17,498 @@
 #include "context.hpp"
 
 Context::Context(Path& file_path)
-  : file_path(file_path), input_stream(nullptr), parse_tree(nullptr)
+  : file_path(file_path), input_stream(nullptr), is_streamed(false), parse_tree(nullptr), has_computed_inclusions(false),
+    is_virtual(false), is_importing(false), reference_count(0), is_pinned(false), is_released(false)
 {
 }
 
+// An in-memory source is never read from disk; its path only serves for messages and for resolving inclusions.
+Context::Context(const Path& file_path, const String& text)
+  : file_path(file_path), input_stream(nullptr), is_streamed(false), parse_tree(nullptr), has_computed_inclusions(false),
+    is_virtual(true), is_importing(false), reference_count(0), is_pinned(false), is_released(false)
+{
+  load(text);
+}
+
+Context::Context(Context&& context)
+  : file_path(context.file_path), input_stream(context.input_stream), is_streamed(context.is_streamed),
+    parse_tree(context.parse_tree), inclusions(context.inclusions), inclusion_names(context.inclusion_names),
+    has_computed_inclusions(context.has_computed_inclusions), headers(context.headers), last_write(context.last_write),
+    is_virtual(context.is_virtual), module(context.module), is_importing(context.is_importing),
+    reference_count(context.reference_count), is_pinned(context.is_pinned), is_released(context.is_released)
+{
+  input_lines.swap(context.input_lines);
+  context.input_stream = nullptr;
+  context.parse_tree = nullptr;
+}
+
 Context::~Context()
 {
   delete parse_tree;
   delete[] input_stream;
 }
 
-void compile(uint argc, uint thread_count, uint thread_id, Vector<Context>& context_list)
+void Context::load(const String& text)
 {
-  for (uint index = thread_id; index < argc; index += thread_count) {
-    try {
-      Context& context = context_list.at(index);
-      Path& file_path = context.file_path;
-      char*& input_stream = context.input_stream;
-      Statement*& parse_tree = context.parse_tree;
-
-      Ifstream file_in(file_path);
-      if (file_in.is_open()) {
-        file_in.seekg(0, std::ios::end);
-        size_t length = file_in.tellg();
-        if (length == (size_t)(-1)) {
-          String message = "error: cannot read " + file_path.string();
-          throw Runtime_error(message);
-        }
-        file_in.seekg(0, std::ios::beg);
-        input_stream = new char[length + 1];
-        file_in.read(input_stream, length);
-        input_stream[length] = '\0';
-        file_in.close();
-
-        Lexer lexer(input_stream);
-        Parser parser(file_path, lexer);
-        String message = "info: compiling " + file_path.string() + "\n";
-        std::cout << message.data();
-        parse_tree = parser.parse();
+  module = nullptr;
+  delete parse_tree;
+  delete[] input_stream;
+  parse_tree = nullptr;
+  is_released = false;
+  input_lines.clear();
+  is_streamed = false;
+  input_stream = new char[text.size() + 1];
+  text.copy(input_stream, text.size());
+  input_stream[text.size()] = '\0';
+}
+
+void Context::compile()
+{
+  module = nullptr;
+  delete parse_tree;
+  parse_tree = nullptr;
+  is_released = false;
+  inclusion_names.clear();
+  has_computed_inclusions = false;
+
+  if (!is_virtual) {
+    delete[] input_stream;
+    input_stream = nullptr;
+    input_lines.clear();
+
+    std::error_code error_code;
+    size_t file_size = std::filesystem::file_size(file_path, error_code);
+    is_streamed = !error_code && file_size >= Stream::min_file_size && file_path.extension() == ".src";
+    if (is_streamed) {
+      last_write = std::filesystem::last_write_time(file_path, error_code);
+      Stream stream(file_path, input_lines);
+      Lexer lexer(stream);
+      Parser parser(file_path, lexer);
+      String message = "info: compiling " + file_path.string() + " (streamed)\n";
+      std::cout << message.data();
+      parse_tree = parser.parse();
+      inclusion_names = parser.get_inclusion_names();
+      has_computed_inclusions = parser.has_computed_inclusions();
+      return;
+    }
+
+    Ifstream file_in(file_path);
+    if (!file_in.is_open()) {
+      String message = "error: cannot open " + file_path.string();
+      throw Runtime_error(message);
+    }
+    last_write = std::filesystem::last_write_time(file_path, error_code);
+    file_in.seekg(0, std::ios::end);
+    size_t length = file_in.tellg();
+    if (length == (size_t)(-1)) {
+      String message = "error: cannot read " + file_path.string();
+      throw Runtime_error(message);
+    }
+    file_in.seekg(0, std::ios::beg);
+    input_stream = new char[length + 1];
+    file_in.read(input_stream, length);
+    input_stream[length] = '\0';
+    file_in.close();
+  }
+
+  Lexer lexer(input_stream);
+  Parser parser(file_path, lexer);
+  String message = "info: compiling " + file_path.string() + "\n";
+  std::cout << message.data();
+  parse_tree = parser.parse();
+  inclusion_names = parser.get_inclusion_names();
+  has_computed_inclusions = parser.has_computed_inclusions();
+}
+
+// Sweeps evaluate the same context from several threads at once.
+static Mutex inclusions_mutex;
+
+// Modules are evaluated under a single lock, which is recursive as a module may import others while being evaluated.
+static Recursive_mutex modules_mutex;
+
+// Evaluates the parse tree in the given environment, and returns the generated text.
+String Context::evaluate(Vector<Context>& context_list, Environment& environment)
+{
+  return evaluate(context_list, environment, nullptr);
+}
+
+// Text streamed from the source is written to the sink as it is evaluated, and only the text generated after it is returned.
+String Context::evaluate(Vector<Context>& context_list, Environment& environment, Ostream* sink)
+{
+  if (parse_tree == nullptr) {
+    String message = "info: skipping " + file_path.string() + " due to previous error(s)";
+    throw Runtime_error(message);
+  }
+  Visitor visitor(file_path, parse_tree, environment, context_list);
+  visitor.set_sink(sink);
+  try {
+    String output_string = visitor.visit();
+    Lock_guard lock(inclusions_mutex);
+    inclusions = environment.get_inclusions();
+    return output_string;
+  }
+  catch (const Runtime_error& error) {
+    Lock_guard lock(inclusions_mutex);
+    inclusions = environment.get_inclusions();
+    throw;
+  }
+}
+
+// Evaluates the parse tree in a fresh environment holding the given globals, and returns the generated text.
+String Context::evaluate(Vector<Context>& context_list, const Hash_map<String, Variant>& globals)
+{
+  Environment environment(file_path, globals);
+  return evaluate(context_list, environment);
+}
+
+// Evaluates the parse tree as a header, and returns the given globals along with the ones it defines.
+Hash_map<String, Variant> Context::evaluate_globals(Vector<Context>& context_list, const Hash_map<String, Variant>& globals)
+{
+  // The globals are handed over to other environments, so their definitions are evaluated right away.
+  Environment environment(file_path, globals);
+  environment.set_lazy(false);
+  evaluate(context_list, environment);
+  return environment.get_globals();
+}
+
+void Context::generate(Vector<Context>& context_list, const Path& out_file_path, const Hash_map<String, Variant>& globals)
+{
+  Path extension = file_path.extension();
+  if (extension == ".src") {
+    if (parse_tree != nullptr) {
+      String message = "info: generating " + out_file_path.string() + "\n";
+      std::cout << message.data();
+      // Redirected outputs are only handed to the writer once the whole source evaluated successfully, along with the main one.
+      Writer writer;
+      Environment environment(file_path, globals);
+      environment.set_out_directory(out_file_path.parent_path());
+      if (is_streamed) {
+        stream(context_list, environment, out_file_path);
       }
       else {
-        String message = "error: cannot open " + file_path.string();
-        throw Runtime_error(message);
+        String output_string = evaluate(context_list, environment);
+        writer.write(out_file_path, output_string);
+      }
+      for (Pair<const Path, String>& output : environment.get_outputs()) {
+        writer.write(output.first, output.second);
       }
+      writer.close();
+    }
+    else {
+      String message = "info: skipping " + out_file_path.string() + " due to previous error(s)";
+      throw Runtime_error(message);
+    }
+  }
+}
+
+// A streamed source is generated into a partial file, which only replaces the output once the generation succeeded.
+void Context::stream(Vector<Context>& context_list, Environment& environment, const Path& out_file_path)
+{
+  Path part_file_path = out_file_path;
+  part_file_path += ".part";
+  Ofstream file_out(part_file_path, std::ios::binary);
+  if (!file_out.is_open()) {
+    String message = "error: cannot create " + part_file_path.string();
+    throw Runtime_error(message);
+  }
+  std::error_code error_code;
+  try {
+    String output_string = evaluate(context_list, environment, &file_out);
+    file_out.write(output_string.data(), output_string.size());
+    file_out.close();
+  }
+  catch (const Runtime_error& error) {
+    file_out.close();
+    std::filesystem::remove(part_file_path, error_code);
+    throw;
+  }
+  std::filesystem::rename(part_file_path, out_file_path, error_code);
+  if (error_code) {
+    std::filesystem::remove(part_file_path, error_code);
+    String message = "error: cannot create " + out_file_path.string();
+    throw Runtime_error(message);
+  }
+}
+
+// Reads the source from the input one top-level statement at a time, and writes the text each generates to the output right away,
+// so that downstream tools consume it as it is produced. The statements are kept, as definitions may point into them, except for
+// top-level text, which is never referred to again. A line holding nothing else is dropped as well, unless the lexer may still be
+// reading it, that is unless it is the last line read.
+void Context::pipe(Vector<Context>& context_list, Istream& input, Ostream& output, const Hash_map<String, Variant>& globals)
+{
+  module = nullptr;
+  delete parse_tree;
+  delete[] input_stream;
+  input_stream = nullptr;
+  input_lines.clear();
+  List<Statement*>* stmt_list = new List<Statement*>();
+  parse_tree = new Compound(stmt_list);
+
+  String message = "info: generating from " + file_path.string() + "\n";
+  std::cout << message.data();
+  Stream stream(input, input_lines);
+  Lexer lexer(stream);
+  Parser parser(file_path, lexer);
+  Environment environment(file_path, globals);
+  Visitor visitor(file_path, parse_tree, environment, context_list);
+  visitor.set_sink(&output);
+  for (Statement* statement = parser.parse_next(); statement != nullptr; statement = parser.parse_next()) {
+    stmt_list->push_back(statement);
+    visitor.visit(statement);
+    Plain_text* plain_text = dynamic_cast<Plain_text*>(statement);
+    if (plain_text != nullptr) {
+      if (input_lines.size() >= 2) {
+        List<String>::iterator line = std::prev(input_lines.end(), 2);
+        if (line->data() == plain_text->token.start && line->size() == plain_text->token.length) {
+          input_lines.erase(line);
+        }
+      }
+      stmt_list->pop_back();
+      delete statement;
+    }
+  }
+  Writer writer;
+  for (Pair<const Path, String>& output : environment.get_outputs()) {
+    writer.write(output.first, output.second);
+  }
+  writer.close();
+}
+
+// Evaluates the context as a header into a module the first time it is imported, and shares that module with every following
+// import until the context is compiled again. Returns null on circular imports.
+Shared_ptr<const Module> Context::import(Vector<Context>& context_list)
+{
+  Recursive_lock lock(modules_mutex);
+  if (module == nullptr) {
+    if (is_importing) {
+      return nullptr;
+    }
+    is_importing = true;
+    // Modules are shared across threads once frozen, so their definitions are evaluated right away.
+    Environment environment(file_path);
+    environment.set_lazy(false);
+    try {
+      evaluate(context_list, environment);
+    }
+    catch (const Runtime_error& error) {
+      is_importing = false;
+      throw;
+    }
+    is_importing = false;
+    module = std::make_shared<const Module>(file_path, environment.get_globals(), environment.get_modules(),
+      environment.get_inclusions());
+  }
+  return module;
+}
+
+// Guards the reference counts, and the release and reload of parse trees.
+static Mutex releases_mutex;
+
+// Returns the parse tree of a context that is included or imported. A source released after its own generation, or a header found
+// in an include directory, is read on demand; an included source is then pinned, as its includer may keep macros and thunks into
+// it. Headers are retained by pending sources.
+Statement* Context::acquire()
+{
+  Lock_guard lock(releases_mutex);
+  if (file_path.extension() != ".dat") {
+    is_pinned = true;
+  }
+  if (is_released) {
+    try {
+      compile();
     }
     catch (const Exception& exception) {
       std::cerr << exception.what() << std::endl;
     }
   }
+  return parse_tree;
 }
 
-void generate(uint argc, uint thread_count, uint thread_id, Vector<Context>& context_list)
+void Context::retain()
 {
-  for (uint index = thread_id; index < argc; index += thread_count) {
+  Lock_guard lock(releases_mutex);
+  reference_count++;
+}
+
+// Deletes the parse tree and the input text once the last reference is released, along with the module that may point into them.
+// Contexts that were never retained are kept, as watchers and servers evaluate them again.
+void Context::release()
+{
+  Lock_guard lock(releases_mutex);
+  if (reference_count == 0) {
+    return;
+  }
+  reference_count--;
+  if (reference_count == 0 && !is_pinned && parse_tree != nullptr) {
+    module = nullptr;
+    delete parse_tree;
+    delete[] input_stream;
+    parse_tree = nullptr;
+    input_stream = nullptr;
+    input_lines.clear();
+    is_released = true;
+  }
+}
+
+// A context is outdated once its file has been written since it was last read. A failed compilation never gets up to date.
+bool Context::is_outdated() const
+{
+  if (is_virtual) {
+    return parse_tree == nullptr;
+  }
+  std::error_code error_code;
+  File_time curr_write = std::filesystem::last_write_time(file_path, error_code);
+  return parse_tree == nullptr || error_code || curr_write != last_write;
+}
+
+// Outputs are written next to their source, unless an output directory is given.
+Path Context::get_out_file_path(const Path& out_directory) const
+{
+  Path out_file_path = out_directory.empty() ? file_path : out_directory / file_path.filename();
+  out_file_path.replace_extension();
+  return out_file_path;
+}
+
+// Paths are compared lexically first, as in-memory sources do not exist on disk, then by file identity for links.
+Context* find_context(Vector<Context>& context_list, const Path& file_path)
+{
+  Path normal_path = file_path.lexically_normal();
+  for (Context& context : context_list) {
+    if (context.file_path.lexically_normal() == normal_path) {
+      return &context;
+    }
+  }
+  for (Context& context : context_list) {
+    std::error_code error_code;
+    if (!context.is_virtual && std::filesystem::equivalent(context.file_path, file_path, error_code)) {
+      return &context;
+    }
+  }
+  return nullptr;
+}
+
+// Include directories are searched in order, after the directory of the including file.
+static Vector<Path> include_directories;
+
+// Looks the file up at the given path first, then in every include directory. The path is updated to the one of the context found.
+Context* search_context(Vector<Context>& context_list, Path& file_path, const String& file_name)
+{
+  Context* context = find_context(context_list, file_path);
+  for (uint index = 0; index < include_directories.size() && context == nullptr; index++) {
+    context = find_context(context_list, include_directories[index] / file_name);
+    if (context != nullptr) {
+      file_path = context->file_path;
+    }
+  }
+  return context;
+}
+
+// Registers the headers of the directory, which are only compiled once included or imported.
+void add_include_directory(Vector<Context>& context_list, const Path& directory)
+{
+  include_directories.push_back(directory);
+  std::error_code error_code;
+  for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory, error_code)) {
+    Path file_path = entry.path().lexically_normal();
+    if (file_path.extension() == ".dat" && find_context(context_list, file_path) == nullptr) {
+      context_list.emplace_back(file_path);
+      context_list.back().is_released = true;
+    }
+  }
+  if (error_code) {
+    String message = "warning: cannot read include directory " + directory.string() + "\n";
+    std::cout << message.data();
+  }
+}
+
+// Collects the files a context may include or import, directly or through the files it includes, from the names recorded by the
+// parser. Headers found in an include directory are compiled to be scanned in turn. Returns false on a computed file name, as any
+// header may then be needed.
+static bool collect_inclusions(Vector<Context>& context_list, Context& context, Set<Context*>& visited)
+{
+  if (context.is_released) {
     try {
-      Context& context = context_list.at(index);
-      Path& file_path = context.file_path;
-      Statement*& parse_tree = context.parse_tree;
-
-      Path extension = file_path.extension();
-      if (extension == ".src") {
-        Path out_file_path = file_path;
-        out_file_path.replace_extension();
-
-        if (parse_tree != nullptr) {
-          Environment environment(file_path);
-          Visitor visitor(file_path, parse_tree, environment, context_list);
-          String message = "info: generating " + out_file_path.string() + "\n";
-          std::cout << message.data();
-          String output_string = visitor.visit();
-
-          const char* out_stream = output_string.data();
-          Ofstream file_out(out_file_path);
-          if (file_out.is_open()) {
-            file_out << out_stream;
-            file_out.close();
-          }
-          else {
-            String message = "error: cannot create " + out_file_path.string();
-            throw Runtime_error(message);
+      context.compile();
+    }
+    catch (const Exception& exception) {
+      std::cerr << exception.what() << std::endl;
+    }
+  }
+  if (context.has_computed_inclusions) {
+    return false;
+  }
+  for (const String& incl_file_name : context.inclusion_names) {
+    Path incl_file_path(context.file_path.parent_path());
+    incl_file_path /= incl_file_name;
+    Context* incl_context = search_context(context_list, incl_file_path, incl_file_name);
+    if (incl_context != nullptr && visited.insert(incl_context).second) {
+      if (!collect_inclusions(context_list, *incl_context, visited)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Every source holds a reference on itself and on the headers it may include or import, or on every header when a file name is
+// computed. Sources are then released right after their generation, and headers once no pending source may include them.
+void retain(Vector<Context>& context_list)
+{
+  for (Context& context : context_list) {
+    if (context.file_path.extension() == ".src") {
+      Set<Context*> visited;
+      if (collect_inclusions(context_list, context, visited)) {
+        for (Context* incl_context : visited) {
+          if (incl_context->file_path.extension() == ".dat") {
+            context.headers.push_back(incl_context);
           }
         }
-        else {
-          String message = "info: skipping " + out_file_path.string() + " due to previous error(s)";
-          throw Runtime_error(message);
+      }
+      else {
+        for (Context& header : context_list) {
+          if (header.file_path.extension() == ".dat") {
+            context.headers.push_back(&header);
+          }
         }
       }
+      for (Context* header : context.headers) {
+        header->retain();
+      }
+      context.retain();
+    }
+  }
+}
+
+void compile(uint argc, uint thread_count, uint thread_id, Vector<Context>& context_list)
+{
+  for (uint index = thread_id; index < argc; index += thread_count) {
+    try {
+      Context& context = context_list.at(index);
+      context.compile();
     }
     catch (const Exception& exception) {
       std::cerr << exception.what() << std::endl;
     }
   }
 }
+
+void generate(uint argc, uint thread_count, uint thread_id, Vector<Context>& context_list, const Path& out_directory,
+  const Hash_map<String, Variant>& globals)
+{
+  for (uint index = thread_id; index < argc; index += thread_count) {
+    Context& context = context_list.at(index);
+    try {
+      context.generate(context_list, context.get_out_file_path(out_directory), globals);
+    }
+    catch (const Exception& exception) {
+      std::cerr << exception.what() << std::endl;
+    }
+    if (context.file_path.extension() == ".src") {
+      for (Context* header : context.headers) {
+        header->release();
+      }
+      context.headers.clear();
+      context.release();
+    }
+  }
+}
@@ -22,24 +22,69 @@ class Context;
 #include "environment.hpp"
 #include "filesystem.hpp"
 #include "fstream.hpp"
+#include "hash_map.hpp"
 #include "lexer.hpp"
+#include "memory.hpp"
+#include "module.hpp"
+#include "mutex.hpp"
 #include "parser.hpp"
+#include "set.hpp"
+#include "stream.hpp"
 #include "thread.hpp"
 #include "tree.hpp"
 #include "utility.hpp"
 #include "vector.hpp"
 #include "visitor.hpp"
+#include "writer.hpp"
 
 class Context {
 public:
   Context(Path& file_path);
+  Context(const Path& file_path, const String& text);
+  Context(const Context&) = delete;
+  Context(Context&& context);
   ~Context();
   Path file_path;
   char* input_stream;
+  List<String> input_lines;
+  bool is_streamed;
   Statement* parse_tree;
+  Set<Path> inclusions;
+  Set<String> inclusion_names;
+  bool has_computed_inclusions;
+  Vector<Context*> headers;
+  File_time last_write;
+  bool is_virtual;
+  Shared_ptr<const Module> module;
+  bool is_importing;
+  uint reference_count;
+  bool is_pinned;
+  bool is_released;
+
+  void load(const String& text);
+  void compile();
+  String evaluate(Vector<Context>& context_list, Environment& environment);
+  String evaluate(Vector<Context>& context_list, Environment& environment, Ostream* sink);
+  String evaluate(Vector<Context>& context_list, const Hash_map<String, Variant>& globals);
+  Hash_map<String, Variant> evaluate_globals(Vector<Context>& context_list, const Hash_map<String, Variant>& globals);
+  void generate(Vector<Context>& context_list, const Path& out_file_path, const Hash_map<String, Variant>& globals);
+  void stream(Vector<Context>& context_list, Environment& environment, const Path& out_file_path);
+  void pipe(Vector<Context>& context_list, Istream& input, Ostream& output, const Hash_map<String, Variant>& globals);
+  Shared_ptr<const Module> import(Vector<Context>& context_list);
+  Statement* acquire();
+  void retain();
+  void release();
+  bool is_outdated() const;
+  Path get_out_file_path(const Path& out_directory) const;
 };
 
+Context* find_context(Vector<Context>& context_list, const Path& file_path);
+Context* search_context(Vector<Context>& context_list, Path& file_path, const String& file_name);
+void add_include_directory(Vector<Context>& context_list, const Path& directory);
+
+void retain(Vector<Context>& context_list);
 void compile(uint argc, uint thread_count, uint thread_id, Vector<Context>& context_list);
-void generate(uint argc, uint thread_count, uint thread_id, Vector<Context>& context_list);
+void generate(uint argc, uint thread_count, uint thread_id, Vector<Context>& context_list, const Path& out_directory,
+  const Hash_map<String, Variant>& globals);
 
 #endif // CONTEXT_HPP
@@ -16,89 +16,203 @@
 
 #include "environment.hpp"
 
+Frame::Frame(uint file_index, size_t line, size_t column)
+  : file_index(file_index), line(line), column(column)
+{
+}
+
+// Locals live in a single stack of slots, where each scope starts at a mark; the stacks are reserved up front so that entering
+// and leaving scopes does not allocate, and are served by the arena of the thread.
 Environment::Environment(const Path& file_name)
-  : curr_file(file_name), error_count(0)
+  : locals(Arena::get_resource()), scope_marks(Arena::get_resource()), hidden_ranges(Arena::get_resource()), error_count(0),
+    curr_file(0), call_stack(Arena::get_resource()), is_lazy(true), thunks(Arena::get_resource()),
+    global_limits(Arena::get_resource()), out_directory(file_name.parent_path())
 {
-  locals.push_front(Map<String, Variant>());
+  locals.reserve(64);
+  scope_marks.reserve(32);
+  call_stack.reserve(32);
+  files.push_back(file_name);
   push_block_scope();
 }
 
+Environment::Environment(const Path& file_name, const Hash_map<String, Variant>& globals)
+  : Environment(file_name)
+{
+  this->globals = globals;
+}
+
 Environment::~Environment()
 {
 }
 
 void Environment::put_global(const String& key, const Variant& value)
 {
-  Pair<Map<String, Variant>::iterator, bool> ret;
+  Pair<Hash_map<String, Variant>::iterator, bool> ret;
   ret = globals.insert(Pair<String, Variant>(key, value));
   if (ret.second == false) {
     throw Out_of_range("out_of_range");
   }
+  global_ranks.insert(Pair<String, uint>(key, global_ranks.size()));
 }
 
 void Environment::put_local(const String& key, const Variant& value)
 {
-  Pair<Map<String, Variant>::iterator, bool> ret;
-  ret = locals.front().insert(Pair<String, Variant>(key, value));
+  for (uint index = scope_marks.back(); index < locals.size(); index++) {
+    if (locals[index].first == key) {
+      throw Out_of_range("out_of_range");
+    }
+  }
+  locals.emplace_back(key, value);
+}
+
+// Lazy bindings are replaced by their value once evaluated, or erased if their evaluation fails. Both apply to the innermost
+// binding of the key. An erased local keeps its slot under an empty key, which no identifier matches.
+void Environment::set(const String& key, const Variant& value)
+{
+  uint index = find_local(key);
+  if (index != locals.size()) {
+    locals[index].second = value;
+  }
+  else {
+    globals.at(key) = value;
+  }
+}
+
+void Environment::erase(const String& key)
+{
+  uint index = find_local(key);
+  if (index != locals.size()) {
+    locals[index].first.clear();
+    locals[index].second = Variant();
+  }
+  else {
+    globals.erase(key);
+  }
+}
+
+// Redirected outputs are kept until the end of the evaluation, so that none is written if the source fails.
+void Environment::put_output(const Path& file_name, String& text)
+{
+  Pair<Set<Path>::iterator, bool> ret;
+  ret = out_file_list.insert(file_name);
   if (ret.second == false) {
     throw Out_of_range("out_of_range");
   }
+  outputs[file_name].swap(text);
 }
 
-Variant& Environment::get(const String& key)
+// Imported definitions are shared with other environments, so they are linked rather than copied into the globals. A module
+// is linked once, along with the files it was evaluated from, which are recorded as inclusions.
+void Environment::link(const Shared_ptr<const Module>& module)
 {
-  for (Map<String, Variant>& scope : locals) {
-    Map<String, Variant>::iterator result = scope.find(key);
-    if (result != scope.end()) {
+  for (const Shared_ptr<const Module>& linked : modules) {
+    if (linked == module) {
+      return;
+    }
+  }
+  modules.push_back(module);
+  inclusions.insert(module->file_path.lexically_normal());
+  inclusions.insert(module->inclusions.begin(), module->inclusions.end());
+}
+
+// Locals shadow globals, which shadow imported definitions. A lazy global only sees the globals defined before it, as if it was
+// evaluated where it is defined.
+const Variant& Environment::get(const String& key) const
+{
+  uint index = find_local(key);
+  if (index != locals.size()) {
+    return locals[index].second;
+  }
+  Hash_map<String, Variant>::const_iterator result = globals.find(key);
+  if (result != globals.end()) {
+    Hash_map<String, uint>::const_iterator rank = global_ranks.find(key);
+    if (global_limits.empty() || rank == global_ranks.end() || rank->second < global_limits.back()) {
       return result->second;
     }
   }
-  return globals.at(key);
+  for (const Shared_ptr<const Module>& module : modules) {
+    const Variant* value = module->find(key);
+    if (value != nullptr) {
+      return *value;
+    }
+  }
+  throw Out_of_range("out_of_range");
 }
 
 void Environment::push_block_scope()
 {
-  locals.push_front(Map<String, Variant>());
+  scope_marks.push_back(locals.size());
 }
 
 void Environment::push_func_scope(const Path& file_name, const Token& token)
 {
   push_block_scope();
-  call_stack.push_front(Pair<const Path&, const Token&>(curr_file, token));
-  curr_file = file_name;
+  call_stack.emplace_back(curr_file, token.line, token.column);
+  curr_file = intern(file_name);
 }
 
 void Environment::push_incl_scope(const Path& file_name, const Token& token)
 {
-  call_stack.push_front(Pair<const Path, const Token>(curr_file, token));
-  curr_file = file_name;
+  inclusions.insert(file_name.lexically_normal());
+  call_stack.emplace_back(curr_file, token.line, token.column);
+  curr_file = intern(file_name);
+}
+
+// A thunk is evaluated in the scope it was bound in, so the local scopes opened since are hidden: all of them for a lazy global,
+// those of the macro for a lazy argument. A thunk already under evaluation denotes a circular definition.
+void Environment::push_thunk_scope(const Path& file_name, const Token& token, const Thunk* thunk, uint scope_depth,
+  uint global_limit)
+{
+  for (const Thunk* forced : thunks) {
+    if (forced == thunk) {
+      throw Out_of_range("out_of_range");
+    }
+  }
+  thunks.push_back(thunk);
+  global_limits.push_back(global_limit);
+  uint hidden_start = scope_depth < scope_marks.size() ? scope_marks[scope_depth] : locals.size();
+  hidden_ranges.emplace_back(hidden_start, locals.size());
+  push_block_scope();
+  call_stack.emplace_back(curr_file, token.line, token.column);
+  curr_file = intern(file_name);
 }
 
 void Environment::pop_block_scope()
 {
-  locals.pop_front();
+  locals.erase(locals.begin() + scope_marks.back(), locals.end());
+  scope_marks.pop_back();
 }
 
 void Environment::pop_func_scope()
 {
   pop_block_scope();
-  curr_file = call_stack.front().first;
-  call_stack.pop_front();
+  curr_file = call_stack.back().file_index;
+  call_stack.pop_back();
 }
 
 void Environment::pop_incl_scope()
 {
-  curr_file = call_stack.front().first;
-  call_stack.pop_front();
+  curr_file = call_stack.back().file_index;
+  call_stack.pop_back();
+}
+
+void Environment::pop_thunk_scope()
+{
+  thunks.pop_back();
+  global_limits.pop_back();
+  pop_block_scope();
+  hidden_ranges.pop_back();
+  curr_file = call_stack.back().file_index;
+  call_stack.pop_back();
 }
 
 void Environment::report(const Semantic_error& error)
 {
   if (error_count < 5) {
-    String message = curr_file.string() + ":" + error.message + "\n";
-    for (const Pair<const Path, const Token>& call : call_stack) {
-      message += "from " + call.first.string() + ":" + std::to_string(call.second.line) + ":" + std::to_string(call.second.column)
-        + "\n";
+    String message = files[curr_file].string() + ":" + error.message + "\n";
+    for (Arena_vector<Frame>::const_reverse_iterator call = call_stack.rbegin(); call != call_stack.rend(); call++) {
+      message += "from " + files[call->file_index].string() + ":" + std::to_string(call->line) + ":"
+        + std::to_string(call->column) + "\n";
     }
     std::cerr << message.data();
   }
@@ -114,3 +228,98 @@ uint Environment::get_call_depth() const
 {
   return call_stack.size();
 }
+
+const Set<Path>& Environment::get_inclusions() const
+{
+  return inclusions;
+}
+
+const Hash_map<String, Variant>& Environment::get_globals() const
+{
+  return globals;
+}
+
+const List<Shared_ptr<const Module>>& Environment::get_modules() const
+{
+  return modules;
+}
+
+bool Environment::has_locals() const
+{
+  return !locals.empty();
+}
+
+uint Environment::get_scope_depth() const
+{
+  return scope_marks.size();
+}
+
+// Globals are ranked in the order they are defined, those given to the environment coming first. A thunk bound to a global only
+// sees the globals ranked before it, and one bound to a local sees them all.
+uint Environment::get_global_limit(const String& key) const
+{
+  if (find_local(key) != locals.size()) {
+    return UINT_MAX;
+  }
+  Hash_map<String, uint>::const_iterator rank = global_ranks.find(key);
+  return rank != global_ranks.end() ? rank->second : UINT_MAX;
+}
+
+void Environment::set_lazy(bool is_lazy)
+{
+  this->is_lazy = is_lazy;
+}
+
+bool Environment::get_lazy() const
+{
+  return is_lazy;
+}
+
+void Environment::set_out_directory(const Path& out_directory)
+{
+  this->out_directory = out_directory;
+}
+
+const Path& Environment::get_out_directory() const
+{
+  return out_directory;
+}
+
+Map<Path, String>& Environment::get_outputs()
+{
+  return outputs;
+}
+
+// Scans the locals from the innermost one, skipping the slots hidden by the thunks under evaluation. Returns the slot index,
+// or the number of slots if the key is not bound locally.
+uint Environment::find_local(const String& key) const
+{
+  uint index = locals.size();
+  uint range = hidden_ranges.size();
+  while (index > 0) {
+    if (range > 0 && index <= hidden_ranges[range - 1].second) {
+      if (index > hidden_ranges[range - 1].first) {
+        index = hidden_ranges[range - 1].first;
+      }
+      range--;
+      continue;
+    }
+    index--;
+    if (locals[index].first == key) {
+      return index;
+    }
+  }
+  return locals.size();
+}
+
+// Files are recorded once, and frames refer to them by index.
+uint Environment::intern(const Path& file_name)
+{
+  for (uint index = files.size(); index > 0; index--) {
+    if (files[index - 1].native() == file_name.native()) {
+      return index - 1;
+    }
+  }
+  files.push_back(file_name);
+  return files.size() - 1;
+}
@@ -17,25 +17,48 @@
 #ifndef ENVIRONMENT_HPP
 #define ENVIRONMENT_HPP
 
+#include <climits>
+
 class Environment;
 
+#include "arena.hpp"
 #include "exception.hpp"
 #include "filesystem.hpp"
+#include "hash_map.hpp"
 #include "list.hpp"
 #include "map.hpp"
+#include "memory.hpp"
+#include "module.hpp"
+#include "set.hpp"
 #include "string.hpp"
 #include "utility.hpp"
 #include "variant.hpp"
+#include "vector.hpp"
+
+// A frame records where a macro, an inclusion or a lazy binding was entered from, the file being an index in the file table.
+class Frame {
+public:
+  Frame(uint file_index, size_t line, size_t column);
+  uint file_index;
+  size_t line;
+  size_t column;
+};
 
 class Environment {
 public:
   Environment(const Path& file_name);
+  Environment(const Path& file_name, const Hash_map<String, Variant>& globals);
   ~Environment();
 
   void put_global(const String& key, const Variant& value);
   void put_local(const String& key, const Variant& value);
+  void put_output(const Path& file_name, String& text);
+  void set(const String& key, const Variant& value);
+  void erase(const String& key);
+
+  void link(const Shared_ptr<const Module>& module);
 
-  Variant& get(const String& key);
+  const Variant& get(const String& key) const;
 
   void push_block_scope();
   void push_func_scope(const Path& file_name, const Token& token);
@@ -43,19 +66,52 @@ public:
   void pop_block_scope();
   void pop_func_scope();
   void pop_incl_scope();
+  void push_thunk_scope(const Path& file_name, const Token& token, const Thunk* thunk, uint scope_depth, uint global_limit);
+  void pop_thunk_scope();
 
   void report(const Semantic_error& error);
   uint get_error_count() const;
   uint get_call_depth() const;
+  const Set<Path>& get_inclusions() const;
+  const Hash_map<String, Variant>& get_globals() const;
+  const List<Shared_ptr<const Module>>& get_modules() const;
+  bool has_locals() const;
+  uint get_scope_depth() const;
+  uint get_global_limit(const String& key) const;
+
+  void set_lazy(bool is_lazy);
+  bool get_lazy() const;
+
+  void set_out_directory(const Path& out_directory);
+  const Path& get_out_directory() const;
+  Map<Path, String>& get_outputs();
 
 private:
-  List<Map<String, Variant>> locals;
-  Map<String, Variant> globals;
+  Arena arena;
+  Arena_vector<Pair<String, Variant>> locals;
+  Arena_vector<uint> scope_marks;
+  Arena_vector<Pair<uint, uint>> hidden_ranges;
+  Hash_map<String, Variant> globals;
+  Hash_map<String, uint> global_ranks;
+  List<Shared_ptr<const Module>> modules;
 
   uint error_count;
 
-  Path curr_file;
-  List<Pair<const Path, const Token>> call_stack;
+  Vector<Path> files;
+  uint curr_file;
+  Arena_vector<Frame> call_stack;
+  Set<Path> inclusions;
+
+  bool is_lazy;
+  Arena_vector<const Thunk*> thunks;
+  Arena_vector<uint> global_limits;
+
+  Path out_directory;
+  Set<Path> out_file_list;
+  Map<Path, String> outputs;
+
+  uint find_local(const String& key) const;
+  uint intern(const Path& file_name);
 };
 
 #endif // ENVIRONMENT_HPP
@@ -28,13 +28,17 @@ Preproc_error::~Preproc_error()
 String Preproc_error::format(const Token& token, const String& message)
 {
   String format_message = std::to_string(token.line) + ":" + std::to_string(token.column) + ": " + message + "\n";
+  if (token.start == nullptr) {
+    format_message.pop_back();
+    return format_message;
+  }
   const char* line_start = token.start - token.column + 1;
-  uint length = 0;
+  size_t length = 0;
   while (line_start[length] != '\n' && line_start[length] != '\0') {
     length++;
   }
   format_message += String(line_start, length) + "\n";
-  for (uint offset = 1; offset < token.column; offset++) {
+  for (size_t offset = 1; offset < token.column; offset++) {
     format_message += " ";
   }
   format_message += "^";
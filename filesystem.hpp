@@ -20,5 +20,6 @@
 #include <filesystem>
 
 using Path = std::filesystem::path;
+using File_time = std::filesystem::file_time_type;
 
 #endif // FILESYSTEM_HPP
@@ -21,5 +21,7 @@
 
 using Ifstream = std::ifstream;
 using Ofstream = std::ofstream;
+using Istream = std::istream;
+using Ostream = std::ostream;
 
 #endif // FSTREAM_HPP
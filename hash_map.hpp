@@ -0,0 +1,274 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef HASH_MAP_HPP
+#define HASH_MAP_HPP
+
+#include <cstdint>
+#include <functional>
+
+template<class Key, class T, class Hash>
+class Hash_map;
+
+#include "deque.hpp"
+#include "exception.hpp"
+#include "utility.hpp"
+#include "vector.hpp"
+
+// A hash map keeps its entries in insertion order, so that iterating over it is deterministic, and finds them through an
+// open-addressing table of entry indices probed linearly. Each slot caches the hash of its key, so that keys are only compared on
+// matching hashes, and the table is grown without hashing the keys again. Entries are stored in a deque, so that references to
+// them stay valid as the map grows; erasing an entry is rare, and rebuilds the whole map.
+template<class Key, class T, class Hash = std::hash<Key>>
+class Hash_map {
+public:
+  using value_type = Pair<const Key, T>;
+  using iterator = typename Deque<value_type>::iterator;
+  using const_iterator = typename Deque<value_type>::const_iterator;
+
+  Hash_map();
+  Hash_map(const Hash_map& rhs) = default;
+  Hash_map(Hash_map&& rhs) = default;
+  ~Hash_map() = default;
+
+  Hash_map& operator=(Hash_map rhs);
+
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  size_t size() const;
+  bool empty() const;
+
+  iterator find(const Key& key);
+  const_iterator find(const Key& key) const;
+  size_t count(const Key& key) const;
+  T& at(const Key& key);
+  const T& at(const Key& key) const;
+  T& at(const Key& key, size_t hash);
+  T& operator[](const Key& key);
+
+  Pair<iterator, bool> insert(const value_type& value);
+  size_t erase(const Key& key);
+  void clear();
+
+private:
+  class Slot {
+  public:
+    size_t hash;
+    size_t index;
+  };
+
+  Deque<value_type> entries;
+  Vector<Slot> slots;
+
+  size_t probe(const Key& key, size_t hash) const;
+  void rehash(size_t slot_count);
+};
+
+///////////////////////////////////////////////////////////// PUBLICS //////////////////////////////////////////////////////////////
+
+template<class Key, class T, class Hash>
+Hash_map<Key, T, Hash>::Hash_map()
+  : slots(8, Slot{0, SIZE_MAX})
+{
+}
+
+template<class Key, class T, class Hash>
+Hash_map<Key, T, Hash>& Hash_map<Key, T, Hash>::operator=(Hash_map rhs)
+{
+  entries.swap(rhs.entries);
+  slots.swap(rhs.slots);
+  return *this;
+}
+
+template<class Key, class T, class Hash>
+typename Hash_map<Key, T, Hash>::iterator Hash_map<Key, T, Hash>::begin()
+{
+  return entries.begin();
+}
+
+template<class Key, class T, class Hash>
+typename Hash_map<Key, T, Hash>::iterator Hash_map<Key, T, Hash>::end()
+{
+  return entries.end();
+}
+
+template<class Key, class T, class Hash>
+typename Hash_map<Key, T, Hash>::const_iterator Hash_map<Key, T, Hash>::begin() const
+{
+  return entries.begin();
+}
+
+template<class Key, class T, class Hash>
+typename Hash_map<Key, T, Hash>::const_iterator Hash_map<Key, T, Hash>::end() const
+{
+  return entries.end();
+}
+
+template<class Key, class T, class Hash>
+size_t Hash_map<Key, T, Hash>::size() const
+{
+  return entries.size();
+}
+
+template<class Key, class T, class Hash>
+bool Hash_map<Key, T, Hash>::empty() const
+{
+  return entries.empty();
+}
+
+template<class Key, class T, class Hash>
+typename Hash_map<Key, T, Hash>::iterator Hash_map<Key, T, Hash>::find(const Key& key)
+{
+  const Slot& slot = slots[probe(key, Hash()(key))];
+  return slot.index != SIZE_MAX ? entries.begin() + slot.index : entries.end();
+}
+
+template<class Key, class T, class Hash>
+typename Hash_map<Key, T, Hash>::const_iterator Hash_map<Key, T, Hash>::find(const Key& key) const
+{
+  const Slot& slot = slots[probe(key, Hash()(key))];
+  return slot.index != SIZE_MAX ? entries.begin() + slot.index : entries.end();
+}
+
+template<class Key, class T, class Hash>
+size_t Hash_map<Key, T, Hash>::count(const Key& key) const
+{
+  return slots[probe(key, Hash()(key))].index != SIZE_MAX ? 1 : 0;
+}
+
+template<class Key, class T, class Hash>
+T& Hash_map<Key, T, Hash>::at(const Key& key)
+{
+  const Slot& slot = slots[probe(key, Hash()(key))];
+  if (slot.index == SIZE_MAX) {
+    throw Out_of_range("out_of_range");
+  }
+  return entries[slot.index].second;
+}
+
+template<class Key, class T, class Hash>
+const T& Hash_map<Key, T, Hash>::at(const Key& key) const
+{
+  const Slot& slot = slots[probe(key, Hash()(key))];
+  if (slot.index == SIZE_MAX) {
+    throw Out_of_range("out_of_range");
+  }
+  return entries[slot.index].second;
+}
+
+// Looks a key up with its hash computed beforehand, which must be the one given by the hash function.
+template<class Key, class T, class Hash>
+T& Hash_map<Key, T, Hash>::at(const Key& key, size_t hash)
+{
+  const Slot& slot = slots[probe(key, hash)];
+  if (slot.index == SIZE_MAX) {
+    throw Out_of_range("out_of_range");
+  }
+  return entries[slot.index].second;
+}
+
+template<class Key, class T, class Hash>
+T& Hash_map<Key, T, Hash>::operator[](const Key& key)
+{
+  return insert(value_type(key, T())).first->second;
+}
+
+// The table is kept at most half full, so that probe sequences stay short.
+template<class Key, class T, class Hash>
+Pair<typename Hash_map<Key, T, Hash>::iterator, bool> Hash_map<Key, T, Hash>::insert(const value_type& value)
+{
+  size_t hash = Hash()(value.first);
+  size_t position = probe(value.first, hash);
+  if (slots[position].index != SIZE_MAX) {
+    return Pair<iterator, bool>(entries.begin() + slots[position].index, false);
+  }
+  if ((entries.size() + 1) * 2 > slots.size()) {
+    rehash(slots.size() * 2);
+    position = probe(value.first, hash);
+  }
+  slots[position] = Slot{hash, entries.size()};
+  entries.push_back(value);
+  return Pair<iterator, bool>(entries.end() - 1, true);
+}
+
+template<class Key, class T, class Hash>
+size_t Hash_map<Key, T, Hash>::erase(const Key& key)
+{
+  size_t index = slots[probe(key, Hash()(key))].index;
+  if (index == SIZE_MAX) {
+    return 0;
+  }
+  Deque<value_type> rest;
+  for (size_t item = 0; item < entries.size(); item++) {
+    if (item != index) {
+      rest.push_back(std::move(entries[item]));
+    }
+  }
+  entries.swap(rest);
+  slots.assign(slots.size(), Slot{0, SIZE_MAX});
+  for (size_t item = 0; item < entries.size(); item++) {
+    size_t hash = Hash()(entries[item].first);
+    slots[probe(entries[item].first, hash)] = Slot{hash, item};
+  }
+  return 1;
+}
+
+template<class Key, class T, class Hash>
+void Hash_map<Key, T, Hash>::clear()
+{
+  entries.clear();
+  slots.assign(8, Slot{0, SIZE_MAX});
+}
+
+///////////////////////////////////////////////////////////// PRIVATES /////////////////////////////////////////////////////////////
+
+// Returns the slot holding the key, or the empty slot ending its probe sequence. The slot count is a power of two.
+template<class Key, class T, class Hash>
+size_t Hash_map<Key, T, Hash>::probe(const Key& key, size_t hash) const
+{
+  size_t mask = slots.size() - 1;
+  size_t position = hash & mask;
+  while (slots[position].index != SIZE_MAX) {
+    const Slot& slot = slots[position];
+    if (slot.hash == hash && entries[slot.index].first == key) {
+      break;
+    }
+    position = (position + 1) & mask;
+  }
+  return position;
+}
+
+template<class Key, class T, class Hash>
+void Hash_map<Key, T, Hash>::rehash(size_t slot_count)
+{
+  Vector<Slot> old_slots(slot_count, Slot{0, SIZE_MAX});
+  old_slots.swap(slots);
+  size_t mask = slot_count - 1;
+  for (const Slot& slot : old_slots) {
+    if (slot.index != SIZE_MAX) {
+      size_t position = slot.hash & mask;
+      while (slots[position].index != SIZE_MAX) {
+        position = (position + 1) & mask;
+      }
+      slots[position] = slot;
+    }
+  }
+}
+
+#endif // HASH_MAP_HPP
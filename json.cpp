@@ -0,0 +1,238 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "json.hpp"
+
+#include <cstring>
+
+#define is_digit(c) ((c) >= '0' && (c) <= '9')
+#define is_space(c) ((c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\r')
+
+static Variant parse_value(const char*& curr_char);
+
+static void skip_spaces(const char*& curr_char)
+{
+  while (is_space(*curr_char)) {
+    curr_char++;
+  }
+}
+
+static void expect(const char*& curr_char, char expected)
+{
+  skip_spaces(curr_char);
+  if (*curr_char != expected) {
+    String message = "error: malformed request; expecting '" + String(1, expected) + "'";
+    throw Runtime_error(message);
+  }
+  curr_char++;
+}
+
+static String parse_string(const char*& curr_char)
+{
+  String string;
+  expect(curr_char, '\"');
+  for (;;) {
+    char c = *curr_char++;
+    switch (c) {
+    case '\0':
+      curr_char--;
+      throw Runtime_error("error: malformed request; unterminated string");
+    case '\"':
+      return string;
+    case '\\':
+      c = *curr_char++;
+      switch (c) {
+      case 'b':
+        string += '\b';
+        break;
+      case 'f':
+        string += '\f';
+        break;
+      case 'n':
+        string += '\n';
+        break;
+      case 'r':
+        string += '\r';
+        break;
+      case 't':
+        string += '\t';
+        break;
+      case 'u': {
+        uint code = 0;
+        for (uint digit = 0; digit < 4; digit++) {
+          char h = *curr_char++;
+          code <<= 4;
+          if (is_digit(h)) {
+            code |= h - '0';
+          }
+          else if ((h | 0x20) >= 'a' && (h | 0x20) <= 'f') {
+            code |= (h | 0x20) - 'a' + 10;
+          }
+          else {
+            throw Runtime_error("error: malformed request; invalid unicode escape");
+          }
+        }
+        if (code < 0x80) {
+          string += (char)code;
+        }
+        else if (code < 0x800) {
+          string += (char)(0xc0 | (code >> 6));
+          string += (char)(0x80 | (code & 0x3f));
+        }
+        else {
+          string += (char)(0xe0 | (code >> 12));
+          string += (char)(0x80 | ((code >> 6) & 0x3f));
+          string += (char)(0x80 | (code & 0x3f));
+        }
+        break;
+      }
+      case '\0':
+        curr_char--;
+        throw Runtime_error("error: malformed request; unterminated string");
+      default:
+        string += c;
+        break;
+      }
+      continue;
+    default:
+      string += c;
+      continue;
+    }
+  }
+}
+
+static Variant parse_value(const char*& curr_char)
+{
+  skip_spaces(curr_char);
+  switch (*curr_char) {
+  case '{': {
+    Hash_map<String, Variant> map;
+    curr_char++;
+    skip_spaces(curr_char);
+    if (*curr_char == '}') {
+      curr_char++;
+      return map;
+    }
+    for (;;) {
+      String key = parse_string(curr_char);
+      expect(curr_char, ':');
+      Variant value = parse_value(curr_char);
+      map.insert(Pair<String, Variant>(key, value));
+      skip_spaces(curr_char);
+      if (*curr_char != ',') {
+        break;
+      }
+      curr_char++;
+    }
+    expect(curr_char, '}');
+    return map;
+  }
+  case '[': {
+    Vector<Variant> list;
+    curr_char++;
+    skip_spaces(curr_char);
+    if (*curr_char == ']') {
+      curr_char++;
+      return list;
+    }
+    for (;;) {
+      list.push_back(parse_value(curr_char));
+      skip_spaces(curr_char);
+      if (*curr_char != ',') {
+        break;
+      }
+      curr_char++;
+    }
+    expect(curr_char, ']');
+    return list;
+  }
+  case '\"':
+    return parse_string(curr_char);
+  case '-':
+  case '0' ... '9': {
+    const char* start_char = curr_char++;
+    while (is_digit(*curr_char)) {
+      curr_char++;
+    }
+    return std::stoi(String(start_char, curr_char - start_char));
+  }
+  default:
+    if (strncmp(curr_char, "true", 4) == 0) {
+      curr_char += 4;
+      return true;
+    }
+    if (strncmp(curr_char, "false", 5) == 0) {
+      curr_char += 5;
+      return false;
+    }
+    if (strncmp(curr_char, "null", 4) == 0) {
+      curr_char += 4;
+      return Variant();
+    }
+    throw Runtime_error("error: malformed request; unexpected character");
+  }
+}
+
+Variant parse_json(const String& text)
+{
+  const char* curr_char = text.data();
+  Variant value = parse_value(curr_char);
+  skip_spaces(curr_char);
+  if (*curr_char != '\0') {
+    throw Runtime_error("error: malformed request; trailing characters");
+  }
+  return value;
+}
+
+String quote_json(const String& text)
+{
+  String string = "\"";
+  for (char c : text) {
+    switch (c) {
+    case '\"':
+      string += "\\\"";
+      break;
+    case '\\':
+      string += "\\\\";
+      break;
+    case '\n':
+      string += "\\n";
+      break;
+    case '\r':
+      string += "\\r";
+      break;
+    case '\t':
+      string += "\\t";
+      break;
+    default:
+      if ((unsigned char)c < 0x20) {
+        const char* digits = "0123456789abcdef";
+        string += "\\u00";
+        string += digits[(c >> 4) & 0xf];
+        string += digits[c & 0xf];
+      }
+      else {
+        string += c;
+      }
+      break;
+    }
+  }
+  string += "\"";
+  return string;
+}
+
+#undef is_digit
+#undef is_space
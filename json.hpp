@@ -0,0 +1,32 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include "exception.hpp"
+#include "map.hpp"
+#include "string.hpp"
+#include "utility.hpp"
+#include "variant.hpp"
+#include "vector.hpp"
+
+// Minimal reader and writer for the line-delimited JSON protocol of the server. Objects map to dictionaries, arrays to lists,
+// and numbers to integers; null reads as a void value.
+Variant parse_json(const String& text);
+String quote_json(const String& text);
+
+#endif // JSON_HPP
@@ -28,18 +28,26 @@
 Lexer::Lexer(const char* input_stream)
 {
   keywords.insert(Pair<String, Token::Type>("assert",   Token::Type::ASSERT));
+  keywords.insert(Pair<String, Token::Type>("break",    Token::Type::BREAK));
+  keywords.insert(Pair<String, Token::Type>("continue", Token::Type::CONTINUE));
   keywords.insert(Pair<String, Token::Type>("define",   Token::Type::DEFINE));
   keywords.insert(Pair<String, Token::Type>("else",     Token::Type::ELSE));
   keywords.insert(Pair<String, Token::Type>("elseif",   Token::Type::ELSEIF));
   keywords.insert(Pair<String, Token::Type>("endfor",   Token::Type::ENDFOR));
   keywords.insert(Pair<String, Token::Type>("endif",    Token::Type::ENDIF));
   keywords.insert(Pair<String, Token::Type>("endmacro", Token::Type::ENDMACRO));
+  keywords.insert(Pair<String, Token::Type>("endoutput", Token::Type::ENDOUTPUT));
+  keywords.insert(Pair<String, Token::Type>("endwhile", Token::Type::ENDWHILE));
   keywords.insert(Pair<String, Token::Type>("for",      Token::Type::FOR));
   keywords.insert(Pair<String, Token::Type>("if",       Token::Type::IF));
+  keywords.insert(Pair<String, Token::Type>("import",   Token::Type::IMPORT));
   keywords.insert(Pair<String, Token::Type>("include",  Token::Type::INCLUDE));
   keywords.insert(Pair<String, Token::Type>("let",      Token::Type::LET));
   keywords.insert(Pair<String, Token::Type>("macro",    Token::Type::MACRO));
+  keywords.insert(Pair<String, Token::Type>("output",   Token::Type::OUTPUT));
   keywords.insert(Pair<String, Token::Type>("print",    Token::Type::PRINT));
+  keywords.insert(Pair<String, Token::Type>("return",   Token::Type::RETURN));
+  keywords.insert(Pair<String, Token::Type>("while",    Token::Type::WHILE));
 
   builtins.insert(Pair<String, Token::Type>("false",  Token::Type::FALSE));
   builtins.insert(Pair<String, Token::Type>("inside", Token::Type::INSIDE));
@@ -48,8 +56,23 @@ Lexer::Lexer(const char* input_stream)
   builtins.insert(Pair<String, Token::Type>("max",    Token::Type::MAX));
   builtins.insert(Pair<String, Token::Type>("min",    Token::Type::MIN));
   builtins.insert(Pair<String, Token::Type>("size",   Token::Type::SIZE));
+  builtins.insert(Pair<String, Token::Type>("join",   Token::Type::JOIN));
+  builtins.insert(Pair<String, Token::Type>("sum",    Token::Type::SUM));
+  builtins.insert(Pair<String, Token::Type>("sort",   Token::Type::SORT));
+  builtins.insert(Pair<String, Token::Type>("keys",   Token::Type::KEYS));
+  builtins.insert(Pair<String, Token::Type>("values", Token::Type::VALUES));
+  builtins.insert(Pair<String, Token::Type>("reverse", Token::Type::REVERSE));
+  builtins.insert(Pair<String, Token::Type>("hex",    Token::Type::HEX));
+  builtins.insert(Pair<String, Token::Type>("bin",    Token::Type::BIN));
+  builtins.insert(Pair<String, Token::Type>("oct",    Token::Type::OCT));
+  builtins.insert(Pair<String, Token::Type>("dec",    Token::Type::DEC));
+  builtins.insert(Pair<String, Token::Type>("sized",  Token::Type::SIZED));
+  builtins.insert(Pair<String, Token::Type>("bits",   Token::Type::BITS));
+  builtins.insert(Pair<String, Token::Type>("slice",  Token::Type::SLICE));
+  builtins.insert(Pair<String, Token::Type>("concat", Token::Type::CONCAT));
   builtins.insert(Pair<String, Token::Type>("true",   Token::Type::TRUE));
 
+  stream = nullptr;
   curr_char = input_stream;
   curr_line = 1;
   curr_column = 1;
@@ -61,6 +84,13 @@ Lexer::Lexer(const char* input_stream)
   reset();
 }
 
+// A streamed source is fed one line at a time, and every line but the ones of a quotation or directive may be skipped.
+Lexer::Lexer(Stream& stream)
+  : Lexer("")
+{
+  this->stream = &stream;
+}
+
 Lexer::~Lexer()
 {
 }
@@ -69,6 +99,19 @@ Lexer::~Lexer()
 
 Token Lexer::get_token()
 {
+  while (stream != nullptr && *curr_char == '\0') {
+    if (mode == Lexer::Mode::VERILOG) {
+      size_t offset = stream->get_offset();
+      size_t line = curr_line;
+      size_t length = stream->skip_text(curr_line);
+      if (length != 0) {
+        return Token(Token::Type::PLAIN_TEXT, offset, length, line);
+      }
+    }
+    if (!next_line()) {
+      break;
+    }
+  }
   switch (mode) {
   case Lexer::Mode::PREPROCESSOR:
     return preprocessor();
@@ -114,6 +157,9 @@ Token Lexer::preprocessor()
   for (;;) {
     switch (Lexer::advance()) {
     case '\0':
+      if (stream != nullptr && next_line()) {
+        continue;
+      }
       return emit(Token::Type::END_OF_FILE);
 
     case '\n':
@@ -387,6 +433,19 @@ char Lexer::advance()
   return *curr_char++;
 }
 
+// Moves on to the next line of the stream, which starts a new token. Returns false once the stream is exhausted.
+bool Lexer::next_line()
+{
+  const char* line = stream->get_line();
+  if (line == nullptr) {
+    return false;
+  }
+  curr_char = line;
+  curr_column = 1;
+  reset();
+  return true;
+}
+
 void Lexer::synchronize()
 {
   mode = Lexer::Mode::VERILOG;
@@ -26,6 +26,7 @@ class Lexer;
 #include "filesystem.hpp"
 #include "list.hpp"
 #include "map.hpp"
+#include "stream.hpp"
 #include "string.hpp"
 #include "token.hpp"
 #include "utility.hpp"
@@ -33,6 +34,7 @@ class Lexer;
 class Lexer {
 public:
   Lexer(const char* input_stream);
+  Lexer(Stream& stream);
   ~Lexer();
 
   Token get_token();
@@ -48,13 +50,14 @@ private:
   Map<String, Token::Type> keywords;
   Map<String, Token::Type> builtins;
 
+  Stream* stream;
   const char* start_char;
   const char* curr_char;
-  uint start_line;
-  uint curr_line;
-  uint start_column;
-  uint curr_column;
-  uint length;
+  size_t start_line;
+  size_t curr_line;
+  size_t start_column;
+  size_t curr_column;
+  size_t length;
 
   Mode mode;
   bool is_inline;
@@ -69,6 +72,7 @@ private:
   bool match(char expected);
   char advance();
   void reset();
+  bool next_line();
 };
 
 #endif // LEXER_HPP
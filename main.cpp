@@ -21,16 +21,93 @@
 
 int main(int argc, char* argv[])
 {
+  Vector<Context> context_list;
+  Vector<Path> file_list;
+  Vector<Path> include_list;
+  bool is_watching = false;
+  bool is_printing_stats = false;
+  bool is_piping = false;
+  Path server_socket;
+  Path client_socket;
+  Path out_directory;
+  Path sweep_path;
+  String definitions;
+  for (uint arg = 1; arg < (uint)argc; arg++) {
+    String option = argv[arg];
+    if (option == "--watch") {
+      is_watching = true;
+    }
+    else if (option == "--stats") {
+      is_printing_stats = true;
+    }
+    else if (option == "-") {
+      is_piping = true;
+    }
+    else if (option == "-D" && arg + 1 < (uint)argc) {
+      definitions += to_definition(argv[++arg]);
+    }
+    else if (option.size() > 2 && option.compare(0, 2, "-D") == 0) {
+      definitions += to_definition(option.substr(2));
+    }
+    else if (option == "-I" && arg + 1 < (uint)argc) {
+      include_list.push_back(std::filesystem::absolute(argv[++arg]).lexically_normal());
+    }
+    else if (option.size() > 2 && option.compare(0, 2, "-I") == 0) {
+      include_list.push_back(std::filesystem::absolute(option.substr(2)).lexically_normal());
+    }
+    else if ((option == "--server" || option == "--client" || option == "--output-dir" || option == "--sweep")
+      && arg + 1 < (uint)argc) {
+      Path value = argv[++arg];
+      if (option == "--server") {
+        server_socket = value;
+      }
+      else if (option == "--client") {
+        client_socket = value;
+      }
+      else if (option == "--sweep") {
+        sweep_path = std::filesystem::absolute(value).lexically_normal();
+      }
+      else {
+        out_directory = std::filesystem::absolute(value).lexically_normal();
+      }
+    }
+    else {
+      file_list.push_back(std::filesystem::absolute(argv[arg]).lexically_normal());
+    }
+  }
+
+  // When piping, the standard output carries the generated text, so messages go to the standard error instead. Streams are no
+  // longer synchronized with the C library, so that the standard input is read through a buffer.
+  if (is_piping) {
+    std::ios::sync_with_stdio(false);
+  }
+  Ostream output(std::cout.rdbuf());
+  if (is_piping) {
+    std::cout.rdbuf(std::cerr.rdbuf());
+  }
   String message = "Preprocessor v1.0.1\n";
   std::cout << message.data();
 
-  Vector<Context> context_list;
-  for (uint arg = 1; arg < (uint)argc; arg++) {
-    Path file_name = std::filesystem::absolute(argv[arg]);
+  try {
+    if (!server_socket.empty()) {
+      Server server(server_socket);
+      server.run();
+      return 0;
+    }
+    if (!client_socket.empty()) {
+      Client client(client_socket);
+      return client.request(file_list, out_directory);
+    }
+  }
+  catch (const Exception& exception) {
+    std::cerr << exception.what() << std::endl;
+    return 1;
+  }
+
+  for (Path& file_name : file_list) {
     Path file_extension = file_name.extension();
     if (file_extension == ".src" || file_extension == ".dat") {
-      Context context(file_name);
-      context_list.push_back(context);
+      context_list.emplace_back(file_name);
     }
     else {
       String message = "warning: skipping " + file_name.string() + " due to file extension; use '.src' for source files and '.dat' for headers\n";
@@ -40,6 +117,9 @@ int main(int argc, char* argv[])
 
   const uint hard_concur = 1;
   const uint context_size = context_list.size();
+  for (const Path& directory : include_list) {
+    add_include_directory(context_list, directory);
+  }
   const uint thread_count = MIN(hard_concur, context_size);
   Thread* thread_list = new Thread[thread_count];
 
@@ -50,15 +130,72 @@ int main(int argc, char* argv[])
     thread_list[thread_id].join();
   }
 
+  // Command-line definitions are evaluated once as a header, and preloaded into the environment of every source.
+  Hash_map<String, Variant> globals;
+  try {
+    if (!definitions.empty()) {
+      Context command_line(Path("<command-line>"), definitions);
+      command_line.compile();
+      globals = command_line.evaluate_globals(context_list, globals);
+    }
+    // The source read from the standard input resolves its inclusions from the working directory.
+    if (is_piping) {
+      Path stdin_path = std::filesystem::current_path() / "<stdin>";
+      Context context(stdin_path);
+      context.is_virtual = true;
+      context.pipe(context_list, std::cin, output, globals);
+      delete[] thread_list;
+      if (is_printing_stats) {
+        print_memo_stats();
+      }
+      std::cout << "info: finished\n";
+      return 0;
+    }
+    if (!sweep_path.empty()) {
+      Sweep sweep(sweep_path);
+      sweep.run(context_list, globals);
+      delete[] thread_list;
+      if (is_printing_stats) {
+        print_memo_stats();
+      }
+      std::cout << "info: finished\n";
+      return 0;
+    }
+  }
+  catch (const Exception& exception) {
+    std::cerr << exception.what() << std::endl;
+    delete[] thread_list;
+    return 1;
+  }
+
+  // Parse trees are released as soon as no pending source needs them, unless they are watched for changes.
+  if (!is_watching) {
+    retain(context_list);
+  }
   for (uint thread_id = 0; thread_id < thread_count; thread_id++) {
-    thread_list[thread_id] = Thread(generate, context_size, thread_count, thread_id, std::ref(context_list));
+    thread_list[thread_id] = Thread(generate, context_size, thread_count, thread_id, std::ref(context_list),
+      std::cref(out_directory), std::cref(globals));
   }
   for (uint thread_id = 0; thread_id < thread_count; thread_id++) {
     thread_list[thread_id].join();
   }
 
   delete[] thread_list;
+  if (is_printing_stats) {
+    print_memo_stats();
+  }
   std::cout << "info: finished\n";
+
+  if (is_watching) {
+    try {
+      Watcher watcher(context_list, out_directory, globals);
+      watcher.run();
+    }
+    catch (const Exception& exception) {
+      std::cerr << exception.what() << std::endl;
+      return 1;
+    }
+  }
   return 0;
 }
 
@@ -21,9 +21,13 @@
 
 #include "context.hpp"
 #include "filesystem.hpp"
+#include "memo.hpp"
+#include "server.hpp"
 #include "string.hpp"
+#include "sweep.hpp"
 #include "thread.hpp"
 #include "utility.hpp"
 #include "vector.hpp"
+#include "watcher.hpp"
 
 #endif // MAIN_HPP
@@ -0,0 +1,115 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "memo.hpp"
+
+// Every memo is registered, so that statistics can be printed once generation is over. A memo deleted along with its parse tree
+// leaves its statistics behind, in place.
+static Mutex memos_mutex;
+static List<Pair<Memo*, String>> memo_list;
+
+static String to_stats(Memo* memo)
+{
+  return "info: macro '" + memo->name + "' at " + memo->file_path.string() + ":" + std::to_string(memo->line) + ": "
+    + std::to_string(memo->get_hit_count()) + " hit(s), " + std::to_string(memo->get_miss_count()) + " miss(es)\n";
+}
+
+Memo::Memo(const String& name, const Path& file_path, size_t line)
+  : name(name), file_path(file_path), line(line), hit_count(0), miss_count(0)
+{
+  Lock_guard lock(memos_mutex);
+  memo_list.emplace_back(this, String());
+}
+
+Memo::~Memo()
+{
+  bool is_used = get_hit_count() != 0 || get_miss_count() != 0;
+  Lock_guard lock(memos_mutex);
+  for (List<Pair<Memo*, String>>::iterator entry = memo_list.begin(); entry != memo_list.end(); entry++) {
+    if (entry->first == this) {
+      if (is_used) {
+        entry->first = nullptr;
+        entry->second = to_stats(this);
+      }
+      else {
+        memo_list.erase(entry);
+      }
+      break;
+    }
+  }
+}
+
+// Looks the arguments up, and copies the cached text and result on a hit.
+bool Memo::find(const Variant* arguments, uint argument_count, String& text, Variant& result)
+{
+  size_t key = hash(arguments, argument_count);
+  Lock_guard lock(mutex);
+  Map<size_t, List<Entry>>::iterator bucket = entries.find(key);
+  if (bucket != entries.end()) {
+    for (const Entry& entry : bucket->second) {
+      bool is_match = true;
+      for (uint index = 0; index < argument_count && is_match; index++) {
+        is_match = entry.arguments[index].is_identical(arguments[index]);
+      }
+      if (is_match) {
+        text = entry.text;
+        result = entry.result;
+        hit_count++;
+        return true;
+      }
+    }
+  }
+  miss_count++;
+  return false;
+}
+
+void Memo::insert(const Variant* arguments, uint argument_count, const String& text, const Variant& result)
+{
+  size_t key = hash(arguments, argument_count);
+  Entry entry{Vector<Variant>(arguments, arguments + argument_count), text, result};
+  Lock_guard lock(mutex);
+  entries[key].push_back(entry);
+}
+
+uint Memo::get_hit_count()
+{
+  Lock_guard lock(mutex);
+  return hit_count;
+}
+
+uint Memo::get_miss_count()
+{
+  Lock_guard lock(mutex);
+  return miss_count;
+}
+
+size_t Memo::hash(const Variant* arguments, uint argument_count)
+{
+  size_t seed = argument_count;
+  for (uint index = 0; index < argument_count; index++) {
+    seed ^= arguments[index].hash() + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
+void print_memo_stats()
+{
+  Lock_guard lock(memos_mutex);
+  for (const Pair<Memo*, String>& entry : memo_list) {
+    String message = entry.first != nullptr ? to_stats(entry.first) : entry.second;
+    std::cout << message.data();
+  }
+}
@@ -0,0 +1,69 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef MEMO_HPP
+#define MEMO_HPP
+
+#include <iostream>
+
+class Memo;
+
+#include "filesystem.hpp"
+#include "list.hpp"
+#include "map.hpp"
+#include "mutex.hpp"
+#include "string.hpp"
+#include "utility.hpp"
+#include "variant.hpp"
+#include "vector.hpp"
+
+// A memo caches the text generated and the value returned by a pure macro, keyed by its arguments. A macro is pure when its text
+// only depends on its arguments, as checked by the parser. Memos are shared by every thread evaluating the macro, and count their
+// hits and misses.
+class Memo {
+public:
+  Memo(const String& name, const Path& file_path, size_t line);
+  ~Memo();
+
+  const String name;
+  const Path file_path;
+  const size_t line;
+
+  bool find(const Variant* arguments, uint argument_count, String& text, Variant& result);
+  void insert(const Variant* arguments, uint argument_count, const String& text, const Variant& result);
+
+  uint get_hit_count();
+  uint get_miss_count();
+
+private:
+  class Entry {
+  public:
+    Vector<Variant> arguments;
+    String text;
+    Variant result;
+  };
+
+  Mutex mutex;
+  Map<size_t, List<Entry>> entries;
+  uint hit_count;
+  uint miss_count;
+
+  static size_t hash(const Variant* arguments, uint argument_count);
+};
+
+void print_memo_stats();
+
+#endif // MEMO_HPP
@@ -0,0 +1,43 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "module.hpp"
+
+Module::Module(const Path& file_path, const Hash_map<String, Variant>& globals, const List<Shared_ptr<const Module>>& imports,
+  const Set<Path>& inclusions)
+  : file_path(file_path), globals(globals), imports(imports), inclusions(inclusions)
+{
+}
+
+Module::~Module()
+{
+}
+
+// Looks the key up in the module, then in the modules it imports, in import order. Returns null if none defines it.
+const Variant* Module::find(const String& key) const
+{
+  Hash_map<String, Variant>::const_iterator result = globals.find(key);
+  if (result != globals.end()) {
+    return &result->second;
+  }
+  for (const Shared_ptr<const Module>& module : imports) {
+    const Variant* value = module->find(key);
+    if (value != nullptr) {
+      return value;
+    }
+  }
+  return nullptr;
+}
@@ -0,0 +1,47 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef MODULE_HPP
+#define MODULE_HPP
+
+class Module;
+
+#include "filesystem.hpp"
+#include "hash_map.hpp"
+#include "list.hpp"
+#include "memory.hpp"
+#include "set.hpp"
+#include "string.hpp"
+#include "utility.hpp"
+#include "variant.hpp"
+
+// A module is a header evaluated once into a table of globals, which is never modified afterwards. It is shared by every
+// environment importing it, across threads. The modules it imports itself are linked rather than copied.
+class Module {
+public:
+  Module(const Path& file_path, const Hash_map<String, Variant>& globals, const List<Shared_ptr<const Module>>& imports,
+    const Set<Path>& inclusions);
+  ~Module();
+
+  const Path file_path;
+  const Hash_map<String, Variant> globals;
+  const List<Shared_ptr<const Module>> imports;
+  const Set<Path> inclusions;
+
+  const Variant* find(const String& key) const;
+};
+
+#endif // MODULE_HPP
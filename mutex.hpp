@@ -0,0 +1,30 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef MUTEX_HPP
+#define MUTEX_HPP
+
+#include <condition_variable>
+#include <mutex>
+
+using Mutex              = std::mutex;
+using Recursive_mutex    = std::recursive_mutex;
+using Lock_guard         = std::lock_guard<std::mutex>;
+using Recursive_lock     = std::lock_guard<std::recursive_mutex>;
+using Unique_lock        = std::unique_lock<std::mutex>;
+using Condition_variable = std::condition_variable;
+
+#endif // MUTEX_HPP
@@ -19,7 +19,8 @@
 ///////////////////////////////////////////////////////////// PUBLICS //////////////////////////////////////////////////////////////
 
 Parser::Parser(Path& file_path, Lexer& lexer)
-  : file_path(file_path), lexer(lexer), error_count(0)
+  : file_path(file_path), lexer(lexer), error_count(0), macro_depth(0), loop_depth(0), call_count(0), is_pure(true),
+    is_inclusion_computed(false)
 {
 }
 
@@ -42,108 +43,131 @@ Statement* Parser::parse()
   }
   else {
     delete statement;
-    if (error_count >= 5) {
-      String message = file_path.string() + ": " + std::to_string(error_count - 5) + " more error(s)\n";
-      std::cerr << message.data();
+    throw failure();
+  }
+}
+
+// Parses the next top-level statement, so that a piped source is evaluated while it is being read. Returns null at the end of the
+// source.
+Statement* Parser::parse_next()
+{
+  if (curr_token.type == Token::Type::INVALID) {
+    curr_token = lexer.get_token();
+  }
+  Statement* statement = this->statement();
+  if (statement == nullptr) {
+    try {
+      consume(Token::Type::END_OF_FILE);
     }
-    String message = file_path.string() + ": compilation failed due to " + std::to_string(error_count) + " error(s)";
-    throw Runtime_error(message);
+    catch (const Preproc_error& error) {
+      report(error);
+    }
+  }
+  if (error_count == 0) {
+    return statement;
+  }
+  else {
+    delete statement;
+    throw failure();
   }
 }
 
+// The files included or imported under a literal name, as written. A computed name may designate any file.
+const Set<String>& Parser::get_inclusion_names() const
+{
+  return inclusion_names;
+}
+
+bool Parser::has_computed_inclusions() const
+{
+  return is_inclusion_computed;
+}
+
 //////////////////////////////////////////////////////////// STATEMENTS ////////////////////////////////////////////////////////////
 
 Statement* Parser::compound()
 {
   List<Statement*>* stmt_list = new List<Statement*>();
+  for (Statement* statement = this->statement(); statement != nullptr; statement = this->statement()) {
+    stmt_list->push_back(statement);
+  }
+  if (stmt_list->size() == 1) {
+    Statement* statement = stmt_list->front();
+    delete stmt_list;
+    return statement;
+  }
+  else {
+    return new Compound(stmt_list);
+  }
+}
+
+// Returns the next statement, or null once a closing keyword or the end of the source is reached.
+Statement* Parser::statement()
+{
   for (;;) {
     if (match(Token::Type::BACKTICK)) {
       switch (curr_token.type) {
       case Token::Type::NEWLINE:
         advance();
         continue;
-      case Token::Type::ASSERT: {
-        Statement* statement = assertion();
-        stmt_list->push_back(statement);
-        continue;
-      }
-      case Token::Type::DEFINE: {
-        Statement* statement = global_var_def();
-        stmt_list->push_back(statement);
-        continue;
-      }
-      case Token::Type::FOR: {
-        Statement* statement = iteration();
-        stmt_list->push_back(statement);
-        continue;
-      }
-      case Token::Type::IF: {
-        Statement* statement = selection();
-        stmt_list->push_back(statement);
-        continue;
-      }
-      case Token::Type::INCLUDE: {
-        Statement* statement = inclusion();
-        stmt_list->push_back(statement);
-        continue;
-      }
-      case Token::Type::LET: {
-        Statement* statement = local_var_def();
-        stmt_list->push_back(statement);
-        continue;
-      }
-      case Token::Type::MACRO: {
-        Statement* statement = macro_def();
-        stmt_list->push_back(statement);
-        continue;
-      }
-      case Token::Type::PRINT: {
-        Statement* statement = printing();
-        stmt_list->push_back(statement);
-        continue;
-      }
+      case Token::Type::ASSERT:
+        return assertion();
+      case Token::Type::BREAK:
+        return break_stmt();
+      case Token::Type::CONTINUE:
+        return continue_stmt();
+      case Token::Type::DEFINE:
+        return global_var_def();
+      case Token::Type::FOR:
+        return iteration();
+      case Token::Type::IF:
+        return selection();
+      case Token::Type::IMPORT:
+        return importation();
+      case Token::Type::INCLUDE:
+        return inclusion();
+      case Token::Type::LET:
+        return local_var_def();
+      case Token::Type::MACRO:
+        return macro_def();
+      case Token::Type::OUTPUT:
+        return redirection();
+      case Token::Type::WHILE:
+        return repetition();
+      case Token::Type::PRINT:
+        return printing();
+      case Token::Type::RETURN:
+        return return_stmt();
       case Token::Type::ELSE:
       case Token::Type::ELSEIF:
       case Token::Type::ENDFOR:
       case Token::Type::ENDIF:
       case Token::Type::ENDMACRO:
-        if (stmt_list->size() == 1) {
-          Statement* statement = stmt_list->front();
-          delete stmt_list;
-          return statement;
-        }
-        else {
-          return new Compound(stmt_list);
-        }
+      case Token::Type::ENDOUTPUT:
+      case Token::Type::ENDWHILE:
+        return nullptr;
       default:
-        Statement* statement = expr_stmt();
-        stmt_list->push_back(statement);
-        continue;
+        return expr_stmt();
       }
     }
     else {
       if (curr_token.type == Token::Type::PLAIN_TEXT) {
-        Statement* statement = plain_text();
-        stmt_list->push_back(statement);
-        continue;
+        return plain_text();
       }
       else {
-        if (stmt_list->size() == 1) {
-          Statement* statement = stmt_list->front();
-          delete stmt_list;
-          return statement;
-        }
-        else {
-          return new Compound(stmt_list);
-        }
+        return nullptr;
       }
     }
   }
 }
 
+// Text streamed from a large source is only located in its file.
 Statement* Parser::plain_text()
 {
   Token token = advance();
+  if (token.start == nullptr) {
+    return new Text_span(token, file_path);
+  }
   return new Plain_text(token);
 }
 
@@ -170,6 +194,7 @@ Statement* Parser::local_var_def()
     storage = lhs_storage();
     consume(Token::Type::EQUAL);
     expression = ternary();
+    bind_name(storage);
     consume(Token::Type::NEWLINE);
   }
   catch (const Preproc_error& error) {
@@ -200,8 +225,10 @@ Statement* Parser::assertion()
 Statement* Parser::global_var_def()
 {
   Token token = advance();
+  mark_impure();
   Storage* storage = nullptr;
   Expression* expression = nullptr;
+  uint outer_call_count = call_count;
   try {
     storage = lhs_storage();
     consume(Token::Type::EQUAL);
@@ -212,23 +239,43 @@ Statement* Parser::global_var_def()
     report(error);
     synchronize();
   }
-  return new Global_var_def(token, storage, expression);
+  // A definition calling a macro or interpolating a template may generate text, so it is only bound lazily when it calls none.
+  Thunk* thunk = call_count == outer_call_count ? new Thunk(file_path, expression, 0) : nullptr;
+  return new Global_var_def(token, storage, expression, thunk);
 }
 
 Statement* Parser::macro_def()
 {
   Token token = advance();
+  mark_impure();
+  bool outer_is_pure = is_pure;
+  Vector<Set<String>> outer_scopes;
+  outer_scopes.swap(scopes);
+  is_pure = true;
+  macro_depth++;
+  push_scope();
+  uint outer_loop_depth = loop_depth;
+  loop_depth = 0;
+
   Storage* storage = nullptr;
   Statement* statement = nullptr;
   List<Identifier*>* parameters = new List<Identifier*>();
+  List<bool>* lazy_flags = new List<bool>();
   try {
     storage = lhs_storage();
+    bind_name(storage);
     consume(Token::Type::LEFT_PAREN);
     if (!match(Token::Type::RIGHT_PAREN)) {
       do {
+        bool is_lazy = match(Token::Type::AMPERS);
         Token token = consume(Token::Type::IDENTIFIER);
         Identifier* parameter = new Identifier(token);
         parameters->push_back(parameter);
+        lazy_flags->push_back(is_lazy);
+        bind_name(token.get_text());
+        if (is_lazy) {
+          mark_impure();
+        }
       } while (match(Token::Type::COMMA));
       consume(Token::Type::RIGHT_PAREN);
     }
@@ -247,13 +294,26 @@ Statement* Parser::macro_def()
     report(error);
     synchronize();
   }
-  Macro* macro = new Macro(file_path, parameters, statement);
+  // A pure macro only depends on its arguments, on its own locals, and on itself for recursion; reading any other name, which
+  // may be a global or a local of the caller, marks it impure.
+  Memo* memo = nullptr;
+  if (is_pure && storage != nullptr) {
+    memo = new Memo(storage->token.get_text(), file_path, token.line);
+  }
+  pop_scope();
+  macro_depth--;
+  loop_depth = outer_loop_depth;
+  is_pure = outer_is_pure;
+  scopes.swap(outer_scopes);
+
+  Macro* macro = new Macro(file_path, parameters, lazy_flags, statement, memo);
   return new Macro_def(token, storage, macro);
 }
 
 Statement* Parser::printing()
 {
   Token token = advance();
+  mark_impure();
   Expression* expression = nullptr;
   try {
     consume(Token::Type::LEFT_PAREN);
@@ -269,6 +329,63 @@ Statement* Parser::printing()
   return printing;
 }
 
+// The returned expression is optional, and a bare return yields nothing.
+Statement* Parser::return_stmt()
+{
+  Token token = advance();
+  Expression* expression = nullptr;
+  try {
+    if (macro_depth == 0) {
+      String message = "unexpected 'return' outside of a macro";
+      throw Syntactic_error(token, message);
+    }
+    if (curr_token.type != Token::Type::NEWLINE) {
+      expression = ternary();
+    }
+    consume(Token::Type::NEWLINE);
+  }
+  catch (const Preproc_error& error) {
+    report(error);
+    synchronize();
+  }
+  Return_stmt* return_stmt = new Return_stmt(token, expression);
+  return return_stmt;
+}
+
+Statement* Parser::break_stmt()
+{
+  Token token = advance();
+  try {
+    if (loop_depth == 0) {
+      String message = "unexpected 'break' outside of a loop";
+      throw Syntactic_error(token, message);
+    }
+    consume(Token::Type::NEWLINE);
+  }
+  catch (const Preproc_error& error) {
+    report(error);
+    synchronize();
+  }
+  return new Break_stmt(token);
+}
+
+Statement* Parser::continue_stmt()
+{
+  Token token = advance();
+  try {
+    if (loop_depth == 0) {
+      String message = "unexpected 'continue' outside of a loop";
+      throw Syntactic_error(token, message);
+    }
+    consume(Token::Type::NEWLINE);
+  }
+  catch (const Preproc_error& error) {
+    report(error);
+    synchronize();
+  }
+  return new Continue_stmt(token);
+}
+
 Statement* Parser::selection()
 {
   Token token = advance();
@@ -285,7 +402,9 @@ Statement* Parser::selection()
       report(error);
       synchronize();
     }
+    push_scope();
     Statement* statement = compound();
+    pop_scope();
     alternatives->push_back(Pair<Expression*, Statement*>(expression, statement));
   }
   while (curr_token.type == Token::Type::ELSEIF) {
@@ -301,7 +420,9 @@ Statement* Parser::selection()
       report(error);
       synchronize();
     }
+    push_scope();
     Statement* statement = compound();
+    pop_scope();
     alternatives->push_back(Pair<Expression*, Statement*>(expression, statement));
   }
   if (curr_token.type == Token::Type::ELSE) {
@@ -314,7 +435,9 @@ Statement* Parser::selection()
       synchronize();
     }
     Expression* expression = new True_const(token);
+    push_scope();
     Statement* statement = compound();
+    pop_scope();
     alternatives->push_back(Pair<Expression*, Statement*>(expression, statement));
   }
   try {
@@ -345,7 +468,15 @@ Statement* Parser::iteration()
     report(error);
     synchronize();
   }
+  push_scope();
+  bind_name("index");
+  if (storage != nullptr) {
+    bind_name(storage);
+  }
+  loop_depth++;
   Statement* statement = compound();
+  loop_depth--;
+  pop_scope();
   try {
     consume(Token::Type::ENDFOR);
     consume(Token::Type::NEWLINE);
@@ -357,12 +488,62 @@ Statement* Parser::iteration()
   return new Iteration(token, storage, expression, statement);
 }
 
+Statement* Parser::repetition()
+{
+  Token token = advance();
+  Expression* expression = nullptr;
+  push_scope();
+  bind_name("index");
+  try {
+    consume(Token::Type::LEFT_PAREN);
+    expression = ternary();
+    consume(Token::Type::RIGHT_PAREN);
+    consume(Token::Type::NEWLINE);
+  }
+  catch (const Preproc_error& error) {
+    report(error);
+    synchronize();
+  }
+  loop_depth++;
+  Statement* statement = compound();
+  loop_depth--;
+  pop_scope();
+  try {
+    consume(Token::Type::ENDWHILE);
+    consume(Token::Type::NEWLINE);
+  }
+  catch (const Preproc_error& error) {
+    report(error);
+    synchronize();
+  }
+  return new Repetition(token, expression, statement);
+}
+
+Statement* Parser::importation()
+{
+  Token token = advance();
+  mark_impure();
+  Expression* expression = nullptr;
+  try {
+    expression = ternary();
+    record_inclusion(expression);
+    consume(Token::Type::NEWLINE);
+  }
+  catch (const Preproc_error& error) {
+    report(error);
+    synchronize();
+  }
+  return new Importation(token, expression);
+}
+
 Statement* Parser::inclusion()
 {
   Token token = advance();
+  mark_impure();
   Expression* expression = nullptr;
   try {
     expression = ternary();
+    record_inclusion(expression);
     consume(Token::Type::NEWLINE);
   }
   catch (const Preproc_error& error) {
@@ -372,6 +553,31 @@ Statement* Parser::inclusion()
   return new Inclusion(token, expression);
 }
 
+Statement* Parser::redirection()
+{
+  Token token = advance();
+  mark_impure();
+  Expression* expression = nullptr;
+  try {
+    expression = ternary();
+    consume(Token::Type::NEWLINE);
+  }
+  catch (const Preproc_error& error) {
+    report(error);
+    synchronize();
+  }
+  Statement* statement = compound();
+  try {
+    consume(Token::Type::ENDOUTPUT);
+    consume(Token::Type::NEWLINE);
+  }
+  catch (const Preproc_error& error) {
+    report(error);
+    synchronize();
+  }
+  return new Redirection(token, expression, statement);
+}
+
 /////////////////////////////////////////////////// RIGHT-HAND SIDE EXPRESSIONS ////////////////////////////////////////////////////
 
 Expression* Parser::ternary()
@@ -681,6 +887,8 @@ Expression* Parser::rhs_prefix()
   }
   case Token::Type::DOLLAR: {
     Token token = advance();
+    mark_impure();
+    call_count++;
     Expression* expression = rhs_prefix();
     return new Interpolate(token, expression);
   }
@@ -701,6 +909,7 @@ Expression* Parser::rhs_prefix()
   }
   case Token::Type::AT_SIGN: {
     Token token = advance();
+    mark_impure();
     Expression* expression = rhs_prefix();
     return new Indirection(token, expression);
   }
@@ -718,6 +927,7 @@ Expression* Parser::rhs_postfix()
       switch (curr_token.type) {
       case Token::Type::LEFT_PAREN: {
         Token token = advance();
+        call_count++;
         List<Expression*>* expr_list = macro_call();
         expression = new Macro_call(token, expression, expr_list);
         continue;
@@ -783,12 +993,41 @@ Expression* Parser::rhs_primary()
     return min_bif();
   case Token::Type::SIZE:
     return size_bif();
+  case Token::Type::JOIN:
+    return join_bif();
+  case Token::Type::SUM:
+    return sum_bif();
+  case Token::Type::SORT:
+    return sort_bif();
+  case Token::Type::KEYS:
+    return keys_bif();
+  case Token::Type::VALUES:
+    return values_bif();
+  case Token::Type::REVERSE:
+    return reverse_bif();
+  case Token::Type::HEX:
+    return hex_bif();
+  case Token::Type::BIN:
+    return bin_bif();
+  case Token::Type::OCT:
+    return oct_bif();
+  case Token::Type::DEC:
+    return dec_bif();
+  case Token::Type::SIZED:
+    return sized_bif();
+  case Token::Type::BITS:
+    return bits_bif();
+  case Token::Type::SLICE:
+    return slice_bif();
+  case Token::Type::CONCAT:
+    return concat_bif();
   case Token::Type::INTEGER: {
     Token token = advance();
     return new Integer(token);
   }
   case Token::Type::IDENTIFIER: {
     Token token = advance();
+    use_name(token);
     return new Identifier(token);
   }
   case Token::Type::TRUE: {
@@ -877,7 +1116,11 @@ Expression* Parser::array()
       } while (match(Token::Type::COMMA));
     }
     consume(Token::Type::RIGHT_BRACK);
-    return new Array(token, expr_list);
+    bool is_constant = true;
+    for (Pair<Expression*, Expression*>& pair : *expr_list) {
+      is_constant = is_constant && is_literal(pair.first) && (pair.second == nullptr || is_literal(pair.second));
+    }
+    return new Array(token, expr_list, is_constant);
   }
   catch (const Preproc_error& error) {
     delete left_expr;
@@ -1023,12 +1266,201 @@ Expression* Parser::size_bif()
   }
 }
 
+Expression* Parser::join_bif()
+{
+  Expression* left_expr = nullptr;
+  Expression* right_expr = nullptr;
+  try {
+    Token token = advance();
+    consume(Token::Type::LEFT_PAREN);
+    left_expr = ternary();
+    consume(Token::Type::COMMA);
+    right_expr = ternary();
+    consume(Token::Type::RIGHT_PAREN);
+    return new Join_bif(token, left_expr, right_expr);
+  }
+  catch (const Preproc_error& error) {
+    delete left_expr;
+    delete right_expr;
+    throw error;
+  }
+}
+
+Expression* Parser::sum_bif()
+{
+  Expression* expression = nullptr;
+  try {
+    Token token = advance();
+    consume(Token::Type::LEFT_PAREN);
+    expression = ternary();
+    consume(Token::Type::RIGHT_PAREN);
+    return new Sum_bif(token, expression);
+  }
+  catch (const Preproc_error& error) {
+    delete expression;
+    throw error;
+  }
+}
+
+Expression* Parser::sort_bif()
+{
+  Expression* expression = nullptr;
+  try {
+    Token token = advance();
+    consume(Token::Type::LEFT_PAREN);
+    expression = ternary();
+    consume(Token::Type::RIGHT_PAREN);
+    return new Sort_bif(token, expression);
+  }
+  catch (const Preproc_error& error) {
+    delete expression;
+    throw error;
+  }
+}
+
+Expression* Parser::keys_bif()
+{
+  Expression* expression = nullptr;
+  try {
+    Token token = advance();
+    consume(Token::Type::LEFT_PAREN);
+    expression = ternary();
+    consume(Token::Type::RIGHT_PAREN);
+    return new Keys_bif(token, expression);
+  }
+  catch (const Preproc_error& error) {
+    delete expression;
+    throw error;
+  }
+}
+
+Expression* Parser::values_bif()
+{
+  Expression* expression = nullptr;
+  try {
+    Token token = advance();
+    consume(Token::Type::LEFT_PAREN);
+    expression = ternary();
+    consume(Token::Type::RIGHT_PAREN);
+    return new Values_bif(token, expression);
+  }
+  catch (const Preproc_error& error) {
+    delete expression;
+    throw error;
+  }
+}
+
+Expression* Parser::reverse_bif()
+{
+  Expression* expression = nullptr;
+  try {
+    Token token = advance();
+    consume(Token::Type::LEFT_PAREN);
+    expression = ternary();
+    consume(Token::Type::RIGHT_PAREN);
+    return new Reverse_bif(token, expression);
+  }
+  catch (const Preproc_error& error) {
+    delete expression;
+    throw error;
+  }
+}
+
+Expression* Parser::hex_bif()
+{
+  Token token = advance();
+  List<Expression*>* expr_list = bif_arguments(token, 1, 2);
+  return new Hex_bif(token, expr_list);
+}
+
+Expression* Parser::bin_bif()
+{
+  Token token = advance();
+  List<Expression*>* expr_list = bif_arguments(token, 1, 2);
+  return new Bin_bif(token, expr_list);
+}
+
+Expression* Parser::oct_bif()
+{
+  Token token = advance();
+  List<Expression*>* expr_list = bif_arguments(token, 1, 2);
+  return new Oct_bif(token, expr_list);
+}
+
+Expression* Parser::dec_bif()
+{
+  Token token = advance();
+  List<Expression*>* expr_list = bif_arguments(token, 1, 2);
+  return new Dec_bif(token, expr_list);
+}
+
+Expression* Parser::sized_bif()
+{
+  Token token = advance();
+  List<Expression*>* expr_list = bif_arguments(token, 2, 3);
+  return new Sized_bif(token, expr_list);
+}
+
+Expression* Parser::bits_bif()
+{
+  Token token = advance();
+  List<Expression*>* expr_list = bif_arguments(token, 2, 2);
+  return new Bits_bif(token, expr_list);
+}
+
+Expression* Parser::slice_bif()
+{
+  Token token = advance();
+  List<Expression*>* expr_list = bif_arguments(token, 3, 3);
+  return new Slice_bif(token, expr_list);
+}
+
+Expression* Parser::concat_bif()
+{
+  Token token = advance();
+  List<Expression*>* expr_list = bif_arguments(token, 2, UINT_MAX);
+  return new Concat_bif(token, expr_list);
+}
+
+// Parses the parenthesized arguments of a builtin, and checks their count. The maximum count is UINT_MAX for no limit.
+List<Expression*>* Parser::bif_arguments(const Token& token, uint min_count, uint max_count)
+{
+  List<Expression*>* expr_list = new List<Expression*>();
+  Expression* expression = nullptr;
+  try {
+    consume(Token::Type::LEFT_PAREN);
+    do {
+      expression = ternary();
+      expr_list->push_back(expression);
+      expression = nullptr;
+    } while (match(Token::Type::COMMA));
+    consume(Token::Type::RIGHT_PAREN);
+    if (expr_list->size() < min_count || expr_list->size() > max_count) {
+      String range = max_count == UINT_MAX ? "at least " + std::to_string(min_count)
+        : std::to_string(min_count) + " to " + std::to_string(max_count);
+      String message = "expecting " + range + " arguments on " + to_string(token.type) + "; found "
+        + std::to_string(expr_list->size());
+      throw Syntactic_error(token, message);
+    }
+    return expr_list;
+  }
+  catch (const Preproc_error& error) {
+    for (Expression*& expression : *expr_list) {
+      delete expression;
+    }
+    delete expr_list;
+    delete expression;
+    throw error;
+  }
+}
+
 //////////////////////////////////////////////////////////// LOCATIONS /////////////////////////////////////////////////////////////
 
 Location* Parser::lhs_prefix()
 {
   if (curr_token.type == Token::Type::AT_SIGN) {
     Token token = advance();
+    mark_impure();
     Expression* expression = rhs_prefix();
     return new Indirection(token, expression);
   }
@@ -1042,6 +1474,7 @@ Location* Parser::lhs_postfix()
   Location* location = nullptr;
   try {
     Token token = consume(Token::Type::IDENTIFIER);
+    use_name(token);
     location = new Identifier(token);
     while (curr_token.type == Token::Type::LEFT_BRACK) {
       Token token = advance();
@@ -1118,12 +1551,111 @@ bool Parser::match(Token::Type type)
   }
 }
 
+// Inside a macro, the parser follows the block scopes the visitor opens, so that every name read can be checked against the
+// names bound at that point.
+void Parser::push_scope()
+{
+  if (macro_depth != 0) {
+    scopes.emplace_back();
+  }
+}
+
+void Parser::pop_scope()
+{
+  if (macro_depth != 0) {
+    scopes.pop_back();
+  }
+}
+
+void Parser::bind_name(Storage* storage)
+{
+  if (storage->token.type == Token::Type::IDENTIFIER) {
+    bind_name(storage->token.get_text());
+  }
+  else {
+    mark_impure();
+  }
+}
+
+void Parser::bind_name(const String& name)
+{
+  if (macro_depth != 0) {
+    scopes.back().insert(name);
+  }
+}
+
+void Parser::use_name(const Token& token)
+{
+  if (macro_depth != 0) {
+    String name = token.get_text();
+    for (const Set<String>& scope : scopes) {
+      if (scope.count(name) != 0) {
+        return;
+      }
+    }
+    mark_impure();
+  }
+}
+
+void Parser::mark_impure()
+{
+  is_pure = false;
+}
+
+void Parser::record_inclusion(Expression* expression)
+{
+  Quotation* quotation = dynamic_cast<Quotation*>(expression);
+  if (quotation == nullptr) {
+    is_inclusion_computed = true;
+    return;
+  }
+  String name;
+  for (Expression* part : *quotation->expr_list) {
+    String_literal* literal = dynamic_cast<String_literal*>(part);
+    if (literal == nullptr) {
+      is_inclusion_computed = true;
+      return;
+    }
+    name += literal->token.get_text();
+  }
+  inclusion_names.insert(name);
+}
+
+bool Parser::is_literal(Expression* expression)
+{
+  if (dynamic_cast<Integer*>(expression) != nullptr || dynamic_cast<True_const*>(expression) != nullptr
+    || dynamic_cast<False_const*>(expression) != nullptr) {
+    return true;
+  }
+  Quotation* quotation = dynamic_cast<Quotation*>(expression);
+  if (quotation != nullptr) {
+    for (Expression* part : *quotation->expr_list) {
+      if (dynamic_cast<String_literal*>(part) == nullptr && dynamic_cast<Escape_seq*>(part) == nullptr) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
 void Parser::synchronize()
 {
   lexer.synchronize();
   advance();
 }
 
+// Returns the error ending a failed compilation, once the errors that were not reported are counted.
+Runtime_error Parser::failure() const
+{
+  if (error_count >= 5) {
+    String message = file_path.string() + ": " + std::to_string(error_count - 5) + " more error(s)\n";
+    std::cerr << message.data();
+  }
+  String message = file_path.string() + ": compilation failed due to " + std::to_string(error_count) + " error(s)";
+  return Runtime_error(message);
+}
+
 void Parser::report(const Preproc_error& error)
 {
   if (error_count < 5) {
@@ -17,6 +17,7 @@
 #ifndef PARSER_HPP
 #define PARSER_HPP
 
+#include <climits>
 #include <iostream>
 
 class Parser;
@@ -26,10 +27,13 @@ class Parser;
 #include "filesystem.hpp"
 #include "lexer.hpp"
 #include "list.hpp"
+#include "memo.hpp"
+#include "set.hpp"
 #include "string.hpp"
 #include "token.hpp"
 #include "tree.hpp"
 #include "utility.hpp"
+#include "vector.hpp"
 
 class Parser {
 public:
@@ -43,11 +47,24 @@ private:
   Token curr_token;
   uint error_count;
 
+  uint macro_depth;
+  uint loop_depth;
+  uint call_count;
+  bool is_pure;
+  Vector<Set<String>> scopes;
+
+  Set<String> inclusion_names;
+  bool is_inclusion_computed;
+
 public:
   Statement* parse();
+  Statement* parse_next();
+  const Set<String>& get_inclusion_names() const;
+  bool has_computed_inclusions() const;
 
 private:
   Statement* compound();
+  Statement* statement();
   Statement* plain_text();
   Statement* expr_stmt();
   Statement* assertion();
@@ -55,9 +72,15 @@ private:
   Statement* global_var_def();
   Statement* macro_def();
   Statement* printing();
+  Statement* return_stmt();
+  Statement* break_stmt();
+  Statement* continue_stmt();
   Statement* selection();
   Statement* iteration();
+  Statement* repetition();
+  Statement* importation();
   Statement* inclusion();
+  Statement* redirection();
 
   Expression* ternary();
   Expression* logical_or();
@@ -80,6 +103,21 @@ private:
   Expression* max_bif();
   Expression* min_bif();
   Expression* size_bif();
+  Expression* join_bif();
+  Expression* sum_bif();
+  Expression* sort_bif();
+  Expression* keys_bif();
+  Expression* values_bif();
+  Expression* reverse_bif();
+  Expression* hex_bif();
+  Expression* bin_bif();
+  Expression* oct_bif();
+  Expression* dec_bif();
+  Expression* sized_bif();
+  Expression* bits_bif();
+  Expression* slice_bif();
+  Expression* concat_bif();
+  List<Expression*>* bif_arguments(const Token& token, uint min_count, uint max_count);
 
   Expression* rhs_prefix();
   Expression* rhs_postfix();
@@ -98,8 +136,18 @@ private:
   Token consume(Token::Type type);
   bool match(Token::Type type);
 
+  void push_scope();
+  void pop_scope();
+  void bind_name(Storage* storage);
+  void bind_name(const String& name);
+  void use_name(const Token& token);
+  void mark_impure();
+  void record_inclusion(Expression* expression);
+  bool is_literal(Expression* expression);
+
   void synchronize();
   void report(const Preproc_error& error);
+  Runtime_error failure() const;
 };
 
 #endif // PARSER_HPP
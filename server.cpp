@@ -0,0 +1,268 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "server.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static sockaddr_un make_address(const Path& socket_path)
+{
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  String name = socket_path.string();
+  if (name.size() >= sizeof(address.sun_path)) {
+    String message = "error: socket path " + name + " is too long";
+    throw Runtime_error(message);
+  }
+  name.copy(address.sun_path, name.size());
+  return address;
+}
+
+static void send_line(int socket_fd, const String& line)
+{
+  String buffer = line + "\n";
+  const char* curr_char = buffer.data();
+  size_t length = buffer.size();
+  while (length != 0) {
+    ssize_t count = send(socket_fd, curr_char, length, MSG_NOSIGNAL);
+    if (count <= 0) {
+      throw Runtime_error("error: connection lost");
+    }
+    curr_char += count;
+    length -= count;
+  }
+}
+
+///////////////////////////////////////////////////////////// SERVER ///////////////////////////////////////////////////////////////
+
+Server::Server(const Path& socket_path)
+  : socket_path(socket_path)
+{
+  sockaddr_un address = make_address(socket_path);
+  socket_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (socket_fd < 0) {
+    String message = "error: cannot create socket " + socket_path.string();
+    throw Runtime_error(message);
+  }
+  unlink(socket_path.c_str());
+  if (bind(socket_fd, (const sockaddr*)&address, sizeof(address)) < 0 || listen(socket_fd, SOMAXCONN) < 0) {
+    close(socket_fd);
+    String message = "error: cannot listen on " + socket_path.string();
+    throw Runtime_error(message);
+  }
+}
+
+Server::~Server()
+{
+  close(socket_fd);
+  unlink(socket_path.c_str());
+}
+
+void Server::run()
+{
+  String message = "info: listening on " + socket_path.string() + "\n";
+  std::cout << message.data();
+  for (;;) {
+    int client_fd = accept4(socket_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client_fd < 0) {
+      continue;
+    }
+    try {
+      serve(client_fd);
+    }
+    catch (const Exception& exception) {
+      std::cerr << exception.what() << std::endl;
+    }
+    close(client_fd);
+  }
+}
+
+// Answers every request line of a connection until the client hangs up.
+void Server::serve(int client_fd)
+{
+  String buffer;
+  char chunk[4096];
+  for (;;) {
+    size_t newline = buffer.find('\n');
+    if (newline != String::npos) {
+      String request = buffer.substr(0, newline);
+      buffer.erase(0, newline + 1);
+      send_line(client_fd, process(request));
+      continue;
+    }
+    ssize_t count = recv(client_fd, chunk, sizeof(chunk), 0);
+    if (count <= 0) {
+      return;
+    }
+    buffer.append(chunk, count);
+  }
+}
+
+String Server::process(const String& request)
+{
+  Ostringstream out_stream;
+  Ostringstream err_stream;
+  std::streambuf* out_buffer = std::cout.rdbuf(out_stream.rdbuf());
+  std::streambuf* err_buffer = std::cerr.rdbuf(err_stream.rdbuf());
+  bool is_success = false;
+  try {
+    Variant value = parse_json(request);
+    Hash_map<String, Variant>& fields = value.get_dictionary();
+    Hash_map<String, Variant>::iterator files = fields.find("files");
+    Hash_map<String, Variant>::iterator output_dir = fields.find("output_dir");
+    if (files == fields.end()) {
+      throw Runtime_error("error: malformed request; missing \"files\"");
+    }
+    Path out_directory;
+    if (output_dir != fields.end()) {
+      out_directory = std::filesystem::absolute(output_dir->second.get_string()).lexically_normal();
+    }
+    is_success = process(files->second.get_array(), out_directory);
+  }
+  catch (const Bad_variant_access& exception) {
+    std::cerr << "error: malformed request; " << exception.message << std::endl;
+  }
+  catch (const Exception& exception) {
+    std::cerr << exception.what() << std::endl;
+  }
+  std::cout.rdbuf(out_buffer);
+  std::cerr.rdbuf(err_buffer);
+  return "{\"status\": " + quote_json(is_success ? "ok" : "error") + ", \"stdout\": " + quote_json(out_stream.str())
+    + ", \"stderr\": " + quote_json(err_stream.str()) + "}";
+}
+
+// Brings the requested files into the cache, recompiles the outdated ones, and generates the sources. The whole cache remains
+// visible to inclusions, as long as its files are up to date.
+bool Server::process(const Vector<Variant>& file_list, const Path& out_directory)
+{
+  bool is_success = true;
+  Vector<Path> request_list;
+  for (const Variant& file_name : file_list) {
+    Path file_path = std::filesystem::absolute(file_name.get_string()).lexically_normal();
+    Path file_extension = file_path.extension();
+    if (file_extension == ".src" || file_extension == ".dat") {
+      bool is_cached = false;
+      for (Context& context : context_list) {
+        is_cached = is_cached || context.file_path == file_path;
+      }
+      if (!is_cached) {
+        context_list.emplace_back(file_path);
+      }
+      request_list.push_back(file_path);
+    }
+    else {
+      String message = "warning: skipping " + file_path.string() + " due to file extension; use '.src' for source files and '.dat' for headers\n";
+      std::cout << message.data();
+    }
+  }
+
+  for (Context& context : context_list) {
+    bool is_requested = false;
+    for (const Path& file_path : request_list) {
+      is_requested = is_requested || context.file_path == file_path;
+    }
+    if (context.is_outdated() && (is_requested || std::filesystem::exists(context.file_path))) {
+      try {
+        context.compile();
+      }
+      catch (const Exception& exception) {
+        std::cerr << exception.what() << std::endl;
+        is_success = false;
+      }
+    }
+  }
+
+  for (Context& context : context_list) {
+    for (const Path& file_path : request_list) {
+      if (context.file_path == file_path) {
+        try {
+          context.generate(context_list, context.get_out_file_path(out_directory), Hash_map<String, Variant>());
+        }
+        catch (const Exception& exception) {
+          std::cerr << exception.what() << std::endl;
+          is_success = false;
+        }
+        break;
+      }
+    }
+  }
+  std::cout << "info: finished\n";
+  return is_success;
+}
+
+///////////////////////////////////////////////////////////// CLIENT ///////////////////////////////////////////////////////////////
+
+Client::Client(const Path& socket_path)
+{
+  sockaddr_un address = make_address(socket_path);
+  socket_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (socket_fd < 0 || connect(socket_fd, (const sockaddr*)&address, sizeof(address)) < 0) {
+    if (socket_fd >= 0) {
+      close(socket_fd);
+    }
+    String message = "error: cannot connect to " + socket_path.string();
+    throw Runtime_error(message);
+  }
+}
+
+Client::~Client()
+{
+  close(socket_fd);
+}
+
+// Sends a generation request, prints back the messages of the server, and returns the exit status of the request.
+int Client::request(const Vector<Path>& file_list, const Path& out_directory)
+{
+  String request = "{\"files\": [";
+  for (uint index = 0; index < file_list.size(); index++) {
+    if (index != 0) {
+      request += ", ";
+    }
+    request += quote_json(file_list[index].string());
+  }
+  request += "]";
+  if (!out_directory.empty()) {
+    request += ", \"output_dir\": " + quote_json(out_directory.string());
+  }
+  request += "}";
+  send_line(socket_fd, request);
+
+  String response;
+  char chunk[4096];
+  while (response.find('\n') == String::npos) {
+    ssize_t count = recv(socket_fd, chunk, sizeof(chunk), 0);
+    if (count <= 0) {
+      throw Runtime_error("error: connection lost");
+    }
+    response.append(chunk, count);
+  }
+  try {
+    Variant value = parse_json(response.substr(0, response.find('\n')));
+    Hash_map<String, Variant>& fields = value.get_dictionary();
+    std::cout << fields.at("stdout").get_string();
+    std::cerr << fields.at("stderr").get_string();
+    return fields.at("status").get_string() == "ok" ? 0 : 1;
+  }
+  catch (const Bad_variant_access& exception) {
+    String message = "error: malformed response; " + exception.message;
+    throw Runtime_error(message);
+  }
+  catch (const Out_of_range& exception) {
+    throw Runtime_error("error: malformed response; missing field");
+  }
+}
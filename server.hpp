@@ -0,0 +1,69 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef SERVER_HPP
+#define SERVER_HPP
+
+#include <iostream>
+
+class Server;
+class Client;
+
+#include "context.hpp"
+#include "exception.hpp"
+#include "filesystem.hpp"
+#include "json.hpp"
+#include "sstream.hpp"
+#include "string.hpp"
+#include "utility.hpp"
+#include "variant.hpp"
+#include "vector.hpp"
+
+// The server keeps the compiled contexts of every requested file, and recompiles them only once they are modified on disk. Each
+// request is a single line holding a JSON object:
+//   {"files": ["/path/to/file.src", ...], "output_dir": "/path/to/dir"}
+// with "output_dir" being optional. Each response is a single line holding a JSON object:
+//   {"status": "ok" | "error", "stdout": "...", "stderr": "..."}
+// with the messages that a standalone run would have printed.
+class Server {
+public:
+  Server(const Path& socket_path);
+  ~Server();
+
+  void run();
+
+private:
+  Path socket_path;
+  int socket_fd;
+  Vector<Context> context_list;
+
+  void serve(int client_fd);
+  String process(const String& request);
+  bool process(const Vector<Variant>& file_list, const Path& out_directory);
+};
+
+class Client {
+public:
+  Client(const Path& socket_path);
+  ~Client();
+
+  int request(const Vector<Path>& file_list, const Path& out_directory);
+
+private:
+  int socket_fd;
+};
+
+#endif // SERVER_HPP
@@ -0,0 +1,108 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "session.hpp"
+
+Session::Session()
+{
+}
+
+Session::~Session()
+{
+}
+
+void Session::add_file(const Path& file_path)
+{
+  Path normal_path = std::filesystem::absolute(file_path).lexically_normal();
+  Context* context = find_context(context_list, normal_path);
+  if (context == nullptr) {
+    context_list.emplace_back(normal_path);
+  }
+}
+
+// Registering a source again under the same path replaces its text, and drops its parse tree.
+void Session::add_source(const Path& file_path, const String& text)
+{
+  Path normal_path = std::filesystem::absolute(file_path).lexically_normal();
+  Context* context = find_context(context_list, normal_path);
+  if (context == nullptr) {
+    context_list.emplace_back(normal_path, text);
+  }
+  else {
+    context->is_virtual = true;
+    context->load(text);
+  }
+}
+
+void Session::define(const String& key, const Variant& value)
+{
+  globals[key] = value;
+}
+
+// Compiles the sources that were never compiled, or that changed since. Returns whether all of them compiled successfully.
+bool Session::compile()
+{
+  bool is_success = true;
+  for (Context& context : context_list) {
+    if (context.is_outdated()) {
+      try {
+        context.compile();
+      }
+      catch (const Exception& exception) {
+        std::cerr << exception.what() << std::endl;
+        is_success = false;
+      }
+    }
+  }
+  return is_success;
+}
+
+String Session::generate(const Path& file_path)
+{
+  Path normal_path = std::filesystem::absolute(file_path).lexically_normal();
+  Context* context = find_context(context_list, normal_path);
+  if (context == nullptr) {
+    String message = "error: cannot find " + normal_path.string() + " in session";
+    throw Runtime_error(message);
+  }
+  compile();
+  return context->evaluate(context_list, globals);
+}
+
+// Generates every '.src' source of the session, and returns their texts keyed by output path, along with the redirected outputs.
+// Failing sources are left out.
+Map<Path, String> Session::generate()
+{
+  Map<Path, String> output_list;
+  compile();
+  for (Context& context : context_list) {
+    if (context.file_path.extension() == ".src") {
+      try {
+        Path out_file_path = context.file_path;
+        out_file_path.replace_extension();
+        Environment environment(context.file_path, globals);
+        output_list[out_file_path] = context.evaluate(context_list, environment);
+        for (Pair<const Path, String>& output : environment.get_outputs()) {
+          output_list[output.first].swap(output.second);
+        }
+      }
+      catch (const Exception& exception) {
+        std::cerr << exception.what() << std::endl;
+      }
+    }
+  }
+  return output_list;
+}
@@ -0,0 +1,56 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef SESSION_HPP
+#define SESSION_HPP
+
+#include <iostream>
+
+class Session;
+
+#include "context.hpp"
+#include "exception.hpp"
+#include "filesystem.hpp"
+#include "hash_map.hpp"
+#include "map.hpp"
+#include "string.hpp"
+#include "utility.hpp"
+#include "variant.hpp"
+#include "vector.hpp"
+
+// Entry point for embedding the preprocessor. A session holds sources, either read from disk or registered in memory under a
+// virtual path, along with globals preloaded in every generation. Sources are compiled once and their parse trees are reused
+// by every following generation until they change. Diagnostics are printed on the standard streams, as for a standalone run,
+// and failures are thrown as runtime errors.
+class Session {
+public:
+  Session();
+  ~Session();
+
+  void add_file(const Path& file_path);
+  void add_source(const Path& file_path, const String& text);
+  void define(const String& key, const Variant& value);
+
+  bool compile();
+  String generate(const Path& file_path);
+  Map<Path, String> generate();
+
+private:
+  Vector<Context> context_list;
+  Hash_map<String, Variant> globals;
+};
+
+#endif // SESSION_HPP
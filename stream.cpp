@@ -0,0 +1,144 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include <algorithm>
+#include <cstring>
+
+#include "stream.hpp"
+
+Stream::Stream(const Path& file_path, List<String>& lines)
+  : file_in(file_path, std::ios::binary), input(file_in), is_seekable(true), lines(lines), window(window_size), window_start(0),
+    window_end(0), offset(0), is_exhausted(false)
+{
+  if (!file_in.is_open()) {
+    String message = "error: cannot open " + file_path.string();
+    throw Runtime_error(message);
+  }
+}
+
+Stream::Stream(Istream& input, List<String>& lines)
+  : input(input), is_seekable(false), lines(lines), window(window_size), window_start(0), window_end(0), offset(0),
+    is_exhausted(false)
+{
+}
+
+Stream::~Stream()
+{
+}
+
+// Copies the next line, along with its newline, and returns it null-terminated. Returns null once the file is exhausted.
+const char* Stream::get_line()
+{
+  String line;
+  for (;;) {
+    const char* begin = window.data() + window_start;
+    size_t size = window_end - window_start;
+    const char* newline = (const char*)std::memchr(begin, '\n', size);
+    if (newline != nullptr) {
+      size = newline + 1 - begin;
+    }
+    line.append(begin, size);
+    window_start += size;
+    offset += size;
+    if (newline != nullptr || !fill()) {
+      break;
+    }
+  }
+  if (line.empty()) {
+    return nullptr;
+  }
+  lines.push_back(std::move(line));
+  return lines.back().data();
+}
+
+// Skips the lines ahead of the first one holding a backtick, and returns their length, provided they are long enough. Shorter runs
+// are left to be read as lines, as keeping them is cheaper than reading them back each time they are evaluated.
+size_t Stream::skip_text(size_t& line_count)
+{
+  if (!is_seekable) {
+    return 0;
+  }
+  if (window_end - window_start < min_span_size) {
+    fill();
+  }
+  size_t length = 0;
+  for (;;) {
+    const char* begin = window.data() + window_start;
+    size_t size = window_end - window_start;
+    const char* backtick = (const char*)std::memchr(begin, '`', size);
+    bool is_last = backtick == nullptr && is_exhausted;
+    if (!is_last) {
+      // Only whole lines are skipped, so the line holding the backtick is read from its start.
+      const char* limit = backtick != nullptr ? backtick : begin + size;
+      size = 0;
+      for (const char* curr_char = limit; curr_char != begin; curr_char--) {
+        if (curr_char[-1] == '\n') {
+          size = curr_char - begin;
+          break;
+        }
+      }
+    }
+    if (length == 0 && size < min_span_size) {
+      return 0;
+    }
+    line_count += std::count(begin, begin + size, '\n');
+    window_start += size;
+    offset += size;
+    length += size;
+    if (backtick != nullptr || is_last || size == 0 || !fill()) {
+      return length;
+    }
+  }
+}
+
+// Returns the offset in the file of the next character to be read.
+size_t Stream::get_offset() const
+{
+  return offset;
+}
+
+// Moves the characters left to the front of the window, and fills the rest from the input. A pipe is read a line at a time instead,
+// so that every line is evaluated as soon as it is written. Returns false if nothing was read.
+bool Stream::fill()
+{
+  size_t size = window_end - window_start;
+  std::memmove(window.data(), window.data() + window_start, size);
+  window_start = 0;
+  window_end = size;
+  if (is_exhausted) {
+    return false;
+  }
+  size_t count = 0;
+  if (is_seekable) {
+    input.read(window.data() + size, window.size() - size);
+    count = input.gcount();
+    is_exhausted = input.eof();
+  }
+  else {
+    String line;
+    std::getline(input, line);
+    is_exhausted = input.eof() || input.fail();
+    if (!is_exhausted) {
+      line.push_back('\n');
+    }
+    if (window.size() < size + line.size()) {
+      window.resize(size + line.size());
+    }
+    count = line.copy(window.data() + size, line.size());
+  }
+  window_end += count;
+  return count != 0;
+}
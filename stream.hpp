@@ -0,0 +1,64 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef STREAM_HPP
+#define STREAM_HPP
+
+#include <iostream>
+
+class Stream;
+
+#include "exception.hpp"
+#include "filesystem.hpp"
+#include "fstream.hpp"
+#include "list.hpp"
+#include "string.hpp"
+#include "utility.hpp"
+#include "vector.hpp"
+
+// A stream reads a large source through a fixed-size window. Lines are copied into the given list, which outlives the stream as
+// tokens point into it, while long runs of lines without directives are only skipped, and later read back from the file by offset.
+// A source read from a pipe cannot be read back, so its lines are all kept.
+class Stream {
+public:
+  Stream(const Path& file_path, List<String>& lines);
+  Stream(Istream& input, List<String>& lines);
+  ~Stream();
+
+  // Sources at least this long are streamed, and runs of text at least this long are skipped.
+  static constexpr size_t min_file_size = 64 << 20;
+  static constexpr size_t min_span_size = 64 << 10;
+  static constexpr size_t window_size = 1 << 20;
+
+  const char* get_line();
+  size_t skip_text(size_t& line_count);
+  size_t get_offset() const;
+
+private:
+  Ifstream file_in;
+  Istream& input;
+  bool is_seekable;
+  List<String>& lines;
+  Vector<char> window;
+  size_t window_start;
+  size_t window_end;
+  size_t offset;
+  bool is_exhausted;
+
+  bool fill();
+};
+
+#endif // STREAM_HPP
@@ -0,0 +1,120 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "sweep.hpp"
+
+Sweep::Sweep(const Path& sweep_path)
+{
+  Ifstream file_in(sweep_path);
+  if (!file_in.is_open()) {
+    String message = "error: cannot open " + sweep_path.string();
+    throw Runtime_error(message);
+  }
+  String line;
+  uint line_number = 0;
+  while (std::getline(file_in, line)) {
+    line_number++;
+    size_t start = line.find_first_not_of(" \t\r");
+    if (start == String::npos || line[start] == '#') {
+      continue;
+    }
+    size_t end = line.find_first_of(" \t\r", start);
+    Path out_file_path = sweep_path.parent_path() / line.substr(start, end - start);
+    String text;
+    while (end != String::npos && end < line.size()) {
+      size_t next = line.find(';', end);
+      String definition = line.substr(end, next == String::npos ? String::npos : next - end);
+      if (definition.find_first_not_of(" \t\r") != String::npos) {
+        text += to_definition(definition);
+      }
+      end = next == String::npos ? next : next + 1;
+    }
+    Path config_path = sweep_path.string() + ":" + std::to_string(line_number);
+    config_list.emplace_back(config_path, text);
+    out_file_list.push_back(out_file_path.lexically_normal());
+  }
+}
+
+Sweep::~Sweep()
+{
+}
+
+// Generates the single source of the given contexts once per configuration, spreading the configurations across threads.
+void Sweep::run(Vector<Context>& context_list, const Hash_map<String, Variant>& globals)
+{
+  Context* context = nullptr;
+  for (Context& candidate : context_list) {
+    if (candidate.file_path.extension() == ".src") {
+      if (context != nullptr) {
+        throw Runtime_error("error: a sweep expects a single '.src' source file");
+      }
+      context = &candidate;
+    }
+  }
+  if (context == nullptr) {
+    throw Runtime_error("error: a sweep expects a single '.src' source file");
+  }
+
+  for (Context& config : config_list) {
+    try {
+      config.compile();
+    }
+    catch (const Exception& exception) {
+      std::cerr << exception.what() << std::endl;
+    }
+  }
+
+  const uint hard_concur = Thread::hardware_concurrency() != 0 ? Thread::hardware_concurrency() : 1;
+  const uint thread_count = hard_concur < config_list.size() ? hard_concur : config_list.size();
+  Vector<Thread> thread_list;
+  for (uint thread_id = 0; thread_id < thread_count; thread_id++) {
+    thread_list.emplace_back(&Sweep::generate, this, thread_count, thread_id, std::ref(*context), std::ref(context_list),
+      std::cref(globals));
+  }
+  for (Thread& thread : thread_list) {
+    thread.join();
+  }
+}
+
+void Sweep::generate(uint thread_count, uint thread_id, Context& context, Vector<Context>& context_list,
+  const Hash_map<String, Variant>& globals)
+{
+  for (uint index = thread_id; index < config_list.size(); index += thread_count) {
+    try {
+      Context& config = config_list.at(index);
+      Hash_map<String, Variant> config_globals = globals;
+      for (const Pair<const String, Variant>& global : config.evaluate_globals(context_list, Hash_map<String, Variant>())) {
+        config_globals[global.first] = global.second;
+      }
+      context.generate(context_list, out_file_list.at(index), config_globals);
+    }
+    catch (const Exception& exception) {
+      std::cerr << exception.what() << std::endl;
+    }
+  }
+}
+
+// Turns a 'name=expression' option into a global definition; a bare name is defined as true.
+String to_definition(const String& option)
+{
+  size_t equal = option.find('=');
+  if (equal == String::npos) {
+    return "`define " + option + " = true\n";
+  }
+  else {
+    return "`define " + option.substr(0, equal) + " = " + option.substr(equal + 1) + "\n";
+  }
+}
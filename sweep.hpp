@@ -0,0 +1,59 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+
+#include <iostream>
+
+class Sweep;
+
+#include "context.hpp"
+#include "exception.hpp"
+#include "filesystem.hpp"
+#include "fstream.hpp"
+#include "hash_map.hpp"
+#include "string.hpp"
+#include "thread.hpp"
+#include "utility.hpp"
+#include "variant.hpp"
+#include "vector.hpp"
+
+// A sweep generates one template once per configuration. The sweep file holds one configuration per line: the output path,
+// relative to the sweep file, followed by definitions separated by semicolons. Empty lines and lines starting with '#' are
+// ignored. For instance:
+//   bus32.v  width = 32; name = "bus32"
+//   bus64.v  width = 64; name = "bus64"
+// Each configuration gets its own environment, where its definitions override the command-line ones, while the template and
+// headers are compiled once and shared by all of them.
+class Sweep {
+public:
+  Sweep(const Path& sweep_path);
+  ~Sweep();
+
+  void run(Vector<Context>& context_list, const Hash_map<String, Variant>& globals);
+
+private:
+  Vector<Context> config_list;
+  Vector<Path> out_file_list;
+
+  void generate(uint thread_count, uint thread_id, Context& context, Vector<Context>& context_list,
+    const Hash_map<String, Variant>& globals);
+};
+
+String to_definition(const String& option);
+
+#endif // SWEEP_HPP
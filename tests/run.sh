@@ -0,0 +1,34 @@
+#!/bin/sh
+# Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+#
+# This program is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 3 of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+# Pipes every test source through the preprocessor given as argument, and compares the text generated, followed by the errors
+# reported if any, with the expected one. The banner and informative messages are left out, as are the paths in errors.
+# Usage: tests/run.sh path/to/preprocessor
+
+preprocessor="$1"
+failures=0
+for source in "$(dirname "$0")"/*.v.src; do
+  expected="${source%.src}.expected"
+  if "$preprocessor" - < "$source" 2>&1 | grep -v "^Preprocessor \|^info: " | sed "s|[^ ]*/<stdin>|<stdin>|" \
+    | cmp -s - "$expected"; then
+    echo "pass: $source"
+  else
+    echo "fail: $source"
+    failures=$((failures + 1))
+  fi
+done
+exit $failures
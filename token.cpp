@@ -17,12 +17,17 @@
 #include "token.hpp"
 
 Token::Token()
-  : type(Token::Type::INVALID), start(nullptr), length(0), line(0), column(0)
+  : type(Token::Type::INVALID), start(nullptr), length(0), line(0), column(0), offset(0)
 {
 }
 
-Token::Token(Token::Type type, const char* start, uint length, uint line, uint column)
-  : type(type), start(start), length(length), line(line), column(column)
+Token::Token(Token::Type type, const char* start, size_t length, size_t line, size_t column)
+  : type(type), start(start), length(length), line(line), column(column), offset(0)
+{
+}
+
+Token::Token(Token::Type type, size_t offset, size_t length, size_t line)
+  : type(type), start(nullptr), length(length), line(line), column(1), offset(offset)
 {
 }
 
@@ -34,13 +39,12 @@ Token& Token::operator=(const Token& token)
 
 String Token::get_text() const
 {
-  return String(start, length);
+  return start != nullptr ? String(start, length) : String();
 }
 
 String Token::to_string() const
 {
-  return "[" + std::to_string(line) + ":" + std::to_string(column) + "=\"" + String(start, length)
-    + "\"," + ::to_string(type) + "]";
+  return "[" + std::to_string(line) + ":" + std::to_string(column) + "=\"" + get_text() + "\"," + ::to_string(type) + "]";
 }
 
 String to_string(Token::Type type)
@@ -116,6 +120,18 @@ String to_string(Token::Type type)
     return "identifier";
   case Token::Type::ASSERT:
     return "'assert'";
+  case Token::Type::BIN:
+    return "'bin'";
+  case Token::Type::BITS:
+    return "'bits'";
+  case Token::Type::BREAK:
+    return "'break'";
+  case Token::Type::CONCAT:
+    return "'concat'";
+  case Token::Type::CONTINUE:
+    return "'continue'";
+  case Token::Type::DEC:
+    return "'dec'";
   case Token::Type::DEFINE:
     return "'define'";
   case Token::Type::ELSE:
@@ -128,16 +144,28 @@ String to_string(Token::Type type)
     return "'endif'";
   case Token::Type::ENDMACRO:
     return "'endmacro'";
+  case Token::Type::ENDOUTPUT:
+    return "'endoutput'";
+  case Token::Type::ENDWHILE:
+    return "'endwhile'";
   case Token::Type::FALSE:
     return "'false'";
   case Token::Type::FOR:
     return "'for'";
+  case Token::Type::HEX:
+    return "'hex'";
   case Token::Type::IF:
     return "'if'";
+  case Token::Type::IMPORT:
+    return "'import'";
   case Token::Type::INCLUDE:
     return "'include'";
   case Token::Type::INSIDE:
     return "'inside'";
+  case Token::Type::JOIN:
+    return "'join'";
+  case Token::Type::KEYS:
+    return "'keys'";
   case Token::Type::LET:
     return "'let'";
   case Token::Type::LOG2:
@@ -150,12 +178,32 @@ String to_string(Token::Type type)
     return "'max'";
   case Token::Type::MIN:
     return "'min'";
+  case Token::Type::OCT:
+    return "'oct'";
+  case Token::Type::OUTPUT:
+    return "'output'";
   case Token::Type::PRINT:
     return "'print'";
+  case Token::Type::RETURN:
+    return "'return'";
+  case Token::Type::REVERSE:
+    return "'reverse'";
   case Token::Type::SIZE:
     return "'size'";
+  case Token::Type::SIZED:
+    return "'sized'";
+  case Token::Type::SLICE:
+    return "'slice'";
+  case Token::Type::SORT:
+    return "'sort'";
+  case Token::Type::SUM:
+    return "'sum'";
   case Token::Type::TRUE:
     return "'true'";
+  case Token::Type::VALUES:
+    return "'values'";
+  case Token::Type::WHILE:
+    return "'while'";
   case Token::Type::LEFT_BRACK:
     return "'['";
   case Token::Type::ESCAPE_SEQ:
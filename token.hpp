@@ -60,26 +60,48 @@ public:
     PLAIN_TEXT,
     IDENTIFIER,
     ASSERT,
+    BIN,
+    BITS,
+    BREAK,
+    CONCAT,
+    CONTINUE,
+    DEC,
     DEFINE,
     ELSE,
     ELSEIF,
     ENDFOR,
     ENDIF,
     ENDMACRO,
+    ENDOUTPUT,
+    ENDWHILE,
     FALSE,
     FOR,
+    HEX,
     IF,
+    IMPORT,
     INCLUDE,
     INSIDE,
+    JOIN,
+    KEYS,
     LET,
     LOG2,
     CLOG2,
     MACRO,
     MAX,
     MIN,
+    OCT,
+    OUTPUT,
     PRINT,
+    RETURN,
+    REVERSE,
     SIZE,
+    SIZED,
+    SLICE,
+    SORT,
+    SUM,
     TRUE,
+    VALUES,
+    WHILE,
     LEFT_BRACK,
     ESCAPE_SEQ,
     RIGHT_BRACK,
@@ -93,15 +115,18 @@ public:
     INVALID
   };
 
+  // Text streamed from a large source is not kept, so its start is null, and it is read back from the file at its offset.
   const Token::Type type;
   const char* start;
-  const uint length;
-  const uint line;
-  const uint column;
+  const size_t length;
+  const size_t line;
+  const size_t column;
+  const size_t offset;
 
   Token();
   Token(const Token&) = default;
-  Token(Token::Type type, const char* start, uint length, uint line, uint column);
+  Token(Token::Type type, const char* start, size_t length, size_t line, size_t column);
+  Token(Token::Type type, size_t offset, size_t length, size_t line);
   Token& operator=(const Token&);
 
   String get_text() const;
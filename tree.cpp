@@ -58,8 +58,13 @@ Storage::Storage(const Token& token)
 {
 }
 
-Macro::Macro(const Path& file_path, List<Identifier*>* parameters, Statement* statement)
-  : file_path(file_path), parameters(parameters), statement(statement)
+Macro::Macro(const Path& file_path, List<Identifier*>* parameters, List<bool>* lazy_flags, Statement* statement, Memo* memo)
+  : file_path(file_path), parameters(parameters), lazy_flags(lazy_flags), statement(statement), memo(memo)
+{
+}
+
+Thunk::Thunk(const Path& file_path, Expression* expression, uint scope_depth)
+  : file_path(file_path), expression(expression), scope_depth(scope_depth)
 {
 }
 
@@ -75,6 +80,11 @@ Plain_text::Plain_text(const Token& token)
 {
 }
 
+Text_span::Text_span(const Token& token, const Path& file_path)
+  : token(token), file_path(file_path)
+{
+}
+
 Assertion::Assertion(const Token& token, Expression* expression)
   : Directive(token), expression(expression)
 {
@@ -90,8 +100,8 @@ Local_var_def::Local_var_def(const Token& token, Storage* storage, Expression* e
 {
 }
 
-Global_var_def::Global_var_def(const Token& token, Storage* storage, Expression* expression)
-  : Directive(token), storage(storage), expression(expression)
+Global_var_def::Global_var_def(const Token& token, Storage* storage, Expression* expression, Thunk* thunk)
+  : Directive(token), storage(storage), expression(expression), thunk(thunk)
 {
 }
 
@@ -105,6 +115,21 @@ Printing::Printing(const Token& token, Expression* expression)
 {
 }
 
+Return_stmt::Return_stmt(const Token& token, Expression* expression)
+  : Directive(token), expression(expression)
+{
+}
+
+Break_stmt::Break_stmt(const Token& token)
+  : Directive(token)
+{
+}
+
+Continue_stmt::Continue_stmt(const Token& token)
+  : Directive(token)
+{
+}
+
 Selection::Selection(const Token& token, List<Pair<Expression*, Statement*>>* alternatives)
   : Directive(token), alternatives(alternatives)
 {
@@ -115,11 +140,26 @@ Iteration::Iteration(const Token& token, Storage* storage, Expression* expressio
 {
 }
 
+Repetition::Repetition(const Token& token, Expression* expression, Statement* statement)
+  : Directive(token), expression(expression), statement(statement)
+{
+}
+
+Importation::Importation(const Token& token, Expression* expression)
+  : Directive(token), expression(expression)
+{
+}
+
 Inclusion::Inclusion(const Token& token, Expression* expression)
   : Directive(token), expression(expression)
 {
 }
 
+Redirection::Redirection(const Token& token, Expression* expression, Statement* statement)
+  : Directive(token), expression(expression), statement(statement)
+{
+}
+
 ////////////////////////////////////////////////// EXPRESSION CLASSES CONSTRUCTOR //////////////////////////////////////////////////
 
 Ternary::Ternary(const Token& token, Expression* condition, Expression* true_branch,
@@ -278,6 +318,76 @@ Size_bif::Size_bif(const Token& token, Expression* expression)
 {
 }
 
+Join_bif::Join_bif(const Token& token, Expression* left_expr, Expression* right_expr)
+  : Binary_expr(token, left_expr, right_expr)
+{
+}
+
+Sum_bif::Sum_bif(const Token& token, Expression* expression)
+  : Unary_expr(token, expression)
+{
+}
+
+Sort_bif::Sort_bif(const Token& token, Expression* expression)
+  : Unary_expr(token, expression)
+{
+}
+
+Keys_bif::Keys_bif(const Token& token, Expression* expression)
+  : Unary_expr(token, expression)
+{
+}
+
+Values_bif::Values_bif(const Token& token, Expression* expression)
+  : Unary_expr(token, expression)
+{
+}
+
+Reverse_bif::Reverse_bif(const Token& token, Expression* expression)
+  : Unary_expr(token, expression)
+{
+}
+
+Hex_bif::Hex_bif(const Token& token, List<Expression*>* expr_list)
+  : Expression(token), expr_list(expr_list)
+{
+}
+
+Bin_bif::Bin_bif(const Token& token, List<Expression*>* expr_list)
+  : Expression(token), expr_list(expr_list)
+{
+}
+
+Oct_bif::Oct_bif(const Token& token, List<Expression*>* expr_list)
+  : Expression(token), expr_list(expr_list)
+{
+}
+
+Dec_bif::Dec_bif(const Token& token, List<Expression*>* expr_list)
+  : Expression(token), expr_list(expr_list)
+{
+}
+
+Sized_bif::Sized_bif(const Token& token, List<Expression*>* expr_list)
+  : Expression(token), expr_list(expr_list)
+{
+}
+
+Bits_bif::Bits_bif(const Token& token, List<Expression*>* expr_list)
+  : Expression(token), expr_list(expr_list)
+{
+}
+
+Slice_bif::Slice_bif(const Token& token, List<Expression*>* expr_list)
+  : Expression(token), expr_list(expr_list)
+{
+}
+
+Concat_bif::Concat_bif(const Token& token, List<Expression*>* expr_list)
+  : Expression(token), expr_list(expr_list)
+{
+}
+
 Integer::Integer(const Token& token)
   : Primary_expr(token)
 {
@@ -308,8 +418,8 @@ Quotation::Quotation(const Token& token, List<Expression*>* expr_list)
 {
 }
 
-Array::Array(const Token& token, List<Pair<Expression*, Expression*>>* range_list)
-  : Expression(token), range_list(range_list)
+Array::Array(const Token& token, List<Pair<Expression*, Expression*>>* range_list, bool is_constant)
+  : Expression(token), range_list(range_list), is_constant(is_constant)
 {
 }
 
@@ -381,7 +491,13 @@ Macro::~Macro()
     delete parameter;
   }
   delete parameters;
+  delete lazy_flags;
   delete statement;
+  delete memo;
+}
+
+Thunk::~Thunk()
+{
 }
 
 /////////////////////////////////////////////////// STATEMENT CLASSES DESTRUCTOR ///////////////////////////////////////////////////
@@ -398,6 +514,10 @@ Plain_text::~Plain_text()
 {
 }
 
+Text_span::~Text_span()
+{
+}
+
 Assertion::~Assertion()
 {
   delete expression;
@@ -418,6 +538,7 @@ Global_var_def::~Global_var_def()
 {
   delete storage;
   delete expression;
+  delete thunk;
 }
 
 Macro_def::~Macro_def()
@@ -431,6 +552,19 @@ Printing::~Printing()
   delete expression;
 }
 
+Return_stmt::~Return_stmt()
+{
+  delete expression;
+}
+
+Break_stmt::~Break_stmt()
+{
+}
+
+Continue_stmt::~Continue_stmt()
+{
+}
+
 Selection::~Selection()
 {
   for (Pair<Expression*, Statement*>& alternative : *alternatives) {
@@ -447,11 +581,28 @@ Iteration::~Iteration()
   delete statement;
 }
 
+Repetition::~Repetition()
+{
+  delete expression;
+  delete statement;
+}
+
+Importation::~Importation()
+{
+  delete expression;
+}
+
 Inclusion::~Inclusion()
 {
   delete expression;
 }
 
+Redirection::~Redirection()
+{
+  delete expression;
+  delete statement;
+}
+
 ////////////////////////////////////////////////// EXPRESSION CLASSES DESTRUCTOR ///////////////////////////////////////////////////
 
 Ternary::~Ternary()
@@ -574,6 +725,7 @@ Max_bif::~Max_bif()
   for (Expression*& expression : *expr_list) {
     delete expression;
   }
+  delete expr_list;
 }
 
 Min_bif::~Min_bif()
@@ -581,12 +733,101 @@ Min_bif::~Min_bif()
   for (Expression*& expression : *expr_list) {
     delete expression;
   }
+  delete expr_list;
 }
 
 Size_bif::~Size_bif()
 {
 }
 
+Join_bif::~Join_bif()
+{
+}
+
+Sum_bif::~Sum_bif()
+{
+}
+
+Sort_bif::~Sort_bif()
+{
+}
+
+Keys_bif::~Keys_bif()
+{
+}
+
+Values_bif::~Values_bif()
+{
+}
+
+Reverse_bif::~Reverse_bif()
+{
+}
+
+Hex_bif::~Hex_bif()
+{
+  for (Expression*& expression : *expr_list) {
+    delete expression;
+  }
+  delete expr_list;
+}
+
+Bin_bif::~Bin_bif()
+{
+  for (Expression*& expression : *expr_list) {
+    delete expression;
+  }
+  delete expr_list;
+}
+
+Oct_bif::~Oct_bif()
+{
+  for (Expression*& expression : *expr_list) {
+    delete expression;
+  }
+  delete expr_list;
+}
+
+Dec_bif::~Dec_bif()
+{
+  for (Expression*& expression : *expr_list) {
+    delete expression;
+  }
+  delete expr_list;
+}
+
+Sized_bif::~Sized_bif()
+{
+  for (Expression*& expression : *expr_list) {
+    delete expression;
+  }
+  delete expr_list;
+}
+
+Bits_bif::~Bits_bif()
+{
+  for (Expression*& expression : *expr_list) {
+    delete expression;
+  }
+  delete expr_list;
+}
+
+Slice_bif::~Slice_bif()
+{
+  for (Expression*& expression : *expr_list) {
+    delete expression;
+  }
+  delete expr_list;
+}
+
+Concat_bif::~Concat_bif()
+{
+  for (Expression*& expression : *expr_list) {
+    delete expression;
+  }
+  delete expr_list;
+}
+
 Integer::~Integer()
 {
 }
@@ -669,6 +910,11 @@ void Plain_text::evaluate(Visitor* visitor)
   visitor->plain_text(this);
 }
 
+void Text_span::evaluate(Visitor* visitor)
+{
+  visitor->text_span(this);
+}
+
 void Assertion::evaluate(Visitor* visitor)
 {
   visitor->assertion(this);
@@ -699,6 +945,21 @@ void Printing::evaluate(Visitor* visitor)
   visitor->printing(this);
 }
 
+void Return_stmt::evaluate(Visitor* visitor)
+{
+  visitor->return_stmt(this);
+}
+
+void Break_stmt::evaluate(Visitor* visitor)
+{
+  visitor->break_stmt(this);
+}
+
+void Continue_stmt::evaluate(Visitor* visitor)
+{
+  visitor->continue_stmt(this);
+}
+
 void Selection::evaluate(Visitor* visitor)
 {
   visitor->selection(this);
@@ -709,11 +970,26 @@ void Iteration::evaluate(Visitor* visitor)
   visitor->iteration(this);
 }
 
+void Repetition::evaluate(Visitor* visitor)
+{
+  visitor->repetition(this);
+}
+
+void Importation::evaluate(Visitor* visitor)
+{
+  visitor->importation(this);
+}
+
 void Inclusion::evaluate(Visitor* visitor)
 {
   visitor->inclusion(this);
 }
 
+void Redirection::evaluate(Visitor* visitor)
+{
+  visitor->redirection(this);
+}
+
 /////////////////////////////////////////////////// EXPRESSION CLASSES EVALUATION ///////////////////////////////////////////////////
 
 Variant Ternary::evaluate(Visitor* visitor)
@@ -871,6 +1147,76 @@ Variant Size_bif::evaluate(Visitor* visitor)
   return visitor->size_bif(this);
 }
 
+Variant Join_bif::evaluate(Visitor* visitor)
+{
+  return visitor->join_bif(this);
+}
+
+Variant Sum_bif::evaluate(Visitor* visitor)
+{
+  return visitor->sum_bif(this);
+}
+
+Variant Sort_bif::evaluate(Visitor* visitor)
+{
+  return visitor->sort_bif(this);
+}
+
+Variant Keys_bif::evaluate(Visitor* visitor)
+{
+  return visitor->keys_bif(this);
+}
+
+Variant Values_bif::evaluate(Visitor* visitor)
+{
+  return visitor->values_bif(this);
+}
+
+Variant Reverse_bif::evaluate(Visitor* visitor)
+{
+  return visitor->reverse_bif(this);
+}
+
+Variant Hex_bif::evaluate(Visitor* visitor)
+{
+  return visitor->hex_bif(this);
+}
+
+Variant Bin_bif::evaluate(Visitor* visitor)
+{
+  return visitor->bin_bif(this);
+}
+
+Variant Oct_bif::evaluate(Visitor* visitor)
+{
+  return visitor->oct_bif(this);
+}
+
+Variant Dec_bif::evaluate(Visitor* visitor)
+{
+  return visitor->dec_bif(this);
+}
+
+Variant Sized_bif::evaluate(Visitor* visitor)
+{
+  return visitor->sized_bif(this);
+}
+
+Variant Bits_bif::evaluate(Visitor* visitor)
+{
+  return visitor->bits_bif(this);
+}
+
+Variant Slice_bif::evaluate(Visitor* visitor)
+{
+  return visitor->slice_bif(this);
+}
+
+Variant Concat_bif::evaluate(Visitor* visitor)
+{
+  return visitor->concat_bif(this);
+}
+
 Variant Integer::evaluate(Visitor* visitor)
 {
   return visitor->integer(this);
@@ -933,17 +1279,17 @@ Variant Indirection::evaluate(Visitor* visitor)
 
 /////////////////////////////////////////////////////// LOCATIONS REFERENCE ////////////////////////////////////////////////////////
 
-Variant& Identifier::reference(Visitor* visitor)
+const Variant& Identifier::reference(Visitor* visitor)
 {
   return visitor->ref_identifier(this);
 }
 
-Variant& Subscript::reference(Visitor* visitor)
+const Variant& Subscript::reference(Visitor* visitor)
 {
   return visitor->ref_subscript(this);
 }
 
-Variant& Indirection::reference(Visitor* visitor)
+const Variant& Indirection::reference(Visitor* visitor)
 {
   return visitor->ref_indirection(this);
 }
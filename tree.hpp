@@ -56,6 +56,20 @@ class Clog2_bif;
 class Max_bif;
 class Min_bif;
 class Size_bif;
+class Join_bif;
+class Sum_bif;
+class Sort_bif;
+class Keys_bif;
+class Values_bif;
+class Reverse_bif;
+class Hex_bif;
+class Bin_bif;
+class Oct_bif;
+class Dec_bif;
+class Sized_bif;
+class Bits_bif;
+class Slice_bif;
+class Concat_bif;
 class Integer;
 class True_const;
 class False_const;
@@ -70,18 +84,28 @@ class Identifier;
 class Indirection;
 class Compound;
 class Plain_text;
+class Text_span;
 class Assertion;
 class Expr_stmt;
 class Local_var_def;
 class Global_var_def;
 class Macro;
+class Thunk;
 class Macro_def;
 class Printing;
+class Return_stmt;
+class Break_stmt;
+class Continue_stmt;
 class Selection;
 class Iteration;
+class Repetition;
+class Importation;
 class Inclusion;
+class Redirection;
 
 #include "filesystem.hpp"
+#include "memo.hpp"
+#include "memory.hpp"
 #include "string.hpp"
 #include "token.hpp"
 #include "utility.hpp"
@@ -138,7 +162,7 @@ class Location : public Expression {
 public:
   Location(const Token& token);
   ~Location();
-  virtual Variant& reference(Visitor* visitor) = 0;
+  virtual const Variant& reference(Visitor* visitor) = 0;
 };
 
 class Storage : public Location {
@@ -373,6 +397,112 @@ public:
   Variant evaluate(Visitor* visitor) override;
 };
 
+class Join_bif : public Binary_expr {
+public:
+  Join_bif(const Token& token, Expression* left_expr, Expression* right_expr);
+  ~Join_bif();
+  Variant evaluate(Visitor* visitor) override;
+};
+
+class Sum_bif : public Unary_expr {
+public:
+  Sum_bif(const Token& token, Expression* expression);
+  ~Sum_bif();
+  Variant evaluate(Visitor* visitor) override;
+};
+
+class Sort_bif : public Unary_expr {
+public:
+  Sort_bif(const Token& token, Expression* expression);
+  ~Sort_bif();
+  Variant evaluate(Visitor* visitor) override;
+};
+
+class Keys_bif : public Unary_expr {
+public:
+  Keys_bif(const Token& token, Expression* expression);
+  ~Keys_bif();
+  Variant evaluate(Visitor* visitor) override;
+};
+
+class Values_bif : public Unary_expr {
+public:
+  Values_bif(const Token& token, Expression* expression);
+  ~Values_bif();
+  Variant evaluate(Visitor* visitor) override;
+};
+
+class Reverse_bif : public Unary_expr {
+public:
+  Reverse_bif(const Token& token, Expression* expression);
+  ~Reverse_bif();
+  Variant evaluate(Visitor* visitor) override;
+};
+
+class Hex_bif : public Expression {
+public:
+  Hex_bif(const Token& token, List<Expression*>* expr_list);
+  ~Hex_bif();
+  List<Expression*>* expr_list;
+  Variant evaluate(Visitor* visitor) override;
+};
+
+class Bin_bif : public Expression {
+public:
+  Bin_bif(const Token& token, List<Expression*>* expr_list);
+  ~Bin_bif();
+  List<Expression*>* expr_list;
+  Variant evaluate(Visitor* visitor) override;
+};
+
+class Oct_bif : public Expression {
+public:
+  Oct_bif(const Token& token, List<Expression*>* expr_list);
+  ~Oct_bif();
+  List<Expression*>* expr_list;
+  Variant evaluate(Visitor* visitor) override;
+};
+
+class Dec_bif : public Expression {
+public:
+  Dec_bif(const Token& token, List<Expression*>* expr_list);
+  ~Dec_bif();
+  List<Expression*>* expr_list;
+  Variant evaluate(Visitor* visitor) override;
+};
+
+class Sized_bif : public Expression {
+public:
+  Sized_bif(const Token& token, List<Expression*>* expr_list);
+  ~Sized_bif();
+  List<Expression*>* expr_list;
+  Variant evaluate(Visitor* visitor) override;
+};
+
+class Bits_bif : public Expression {
+public:
+  Bits_bif(const Token& token, List<Expression*>* expr_list);
+  ~Bits_bif();
+  List<Expression*>* expr_list;
+  Variant evaluate(Visitor* visitor) override;
+};
+
+class Slice_bif : public Expression {
+public:
+  Slice_bif(const Token& token, List<Expression*>* expr_list);
+  ~Slice_bif();
+  List<Expression*>* expr_list;
+  Variant evaluate(Visitor* visitor) override;
+};
+
+class Concat_bif : public Expression {
+public:
+  Concat_bif(const Token& token, List<Expression*>* expr_list);
+  ~Concat_bif();
+  List<Expression*>* expr_list;
+  Variant evaluate(Visitor* visitor) override;
+};
+
 class Integer : public Primary_expr {
 public:
   explicit Integer(const Token& token);
@@ -408,19 +538,24 @@ public:
   Variant evaluate(Visitor* visitor) override;
 };
 
+// A quotation holds literal text only, so its value is interned and kept from the first evaluation on.
 class Quotation : public Expression {
 public:
   Quotation(const Token& token, List<Expression*>* expr_list);
   ~Quotation();
   List<Expression*>* const expr_list;
+  Shared_ptr<const Variant> value;
   Variant evaluate(Visitor* visitor) override;
 };
 
+// A list of literals only is constant, and its value is kept from the first evaluation on, along with the index of its items.
 class Array : public Expression {
 public:
-  Array(const Token& token, List<Pair<Expression*, Expression*>>* range_list);
+  Array(const Token& token, List<Pair<Expression*, Expression*>>* range_list, bool is_constant);
   ~Array();
   List<Pair<Expression*, Expression*>>* range_list;
+  const bool is_constant;
+  Shared_ptr<const Variant> value;
   Variant evaluate(Visitor* visitor) override;
 };
 
@@ -447,7 +582,7 @@ public:
   ~Subscript();
   Expression* const left_expr;
   Expression* const right_expr;
-  Variant& reference(Visitor* visitor) override;
+  const Variant& reference(Visitor* visitor) override;
   Variant evaluate(Visitor* visitor) override;
 };
 
@@ -457,7 +592,7 @@ public:
   ~Identifier();
   void global_define(Visitor* visitor, const Variant& value) override;
   void local_define(Visitor* visitor, const Variant& value) override;
-  Variant& reference(Visitor* visitor) override;
+  const Variant& reference(Visitor* visitor) override;
   Variant evaluate(Visitor* visitor) override;
 };
 
@@ -468,7 +603,7 @@ public:
   Expression* const expression;
   void global_define(Visitor* visitor, const Variant& value) override;
   void local_define(Visitor* visitor, const Variant& value) override;
-  Variant& reference(Visitor* visitor) override;
+  const Variant& reference(Visitor* visitor) override;
   Variant evaluate(Visitor* visitor) override;
 };
 
@@ -490,6 +625,15 @@ public:
   void evaluate(Visitor* visitor) override;
 };
 
+class Text_span : public Statement {
+public:
+  Text_span(const Token& token, const Path& file_path);
+  ~Text_span();
+  Token token;
+  const Path file_path;
+  void evaluate(Visitor* visitor) override;
+};
+
 class Assertion : public Directive {
 public:
   Assertion(const Token& token, Expression* expression);
@@ -517,20 +661,34 @@ public:
 
 class Global_var_def : public Directive {
 public:
-  Global_var_def(const Token& token, Storage* storage, Expression* expression);
+  Global_var_def(const Token& token, Storage* storage, Expression* expression, Thunk* thunk);
   ~Global_var_def();
   Storage* const storage;
   Expression* const expression;
+  Thunk* const thunk;
   void evaluate(Visitor* visitor) override;
 };
 
 class Macro {
 public:
-  Macro(const Path& file_path, List<Identifier*>* parameters, Statement* statement);
+  Macro(const Path& file_path, List<Identifier*>* parameters, List<bool>* lazy_flags, Statement* statement, Memo* memo);
   ~Macro();
   const Path file_path;
   List<Identifier*>* const parameters;
+  List<bool>* const lazy_flags;
   Statement* const statement;
+  Memo* const memo;
+};
+
+// A thunk holds the expression of a global definition or of a lazy macro argument, along with its file and the depth of the
+// local scopes it sees, so that it can be evaluated on first use.
+class Thunk {
+public:
+  Thunk(const Path& file_path, Expression* expression, uint scope_depth);
+  ~Thunk();
+  Path file_path;
+  Expression* const expression;
+  const uint scope_depth;
 };
 
 class Macro_def : public Directive {
@@ -550,6 +708,28 @@ public:
   void evaluate(Visitor* visitor) override;
 };
 
+class Return_stmt : public Directive {
+public:
+  Return_stmt(const Token& token, Expression* expression);
+  ~Return_stmt();
+  Expression* const expression;
+  void evaluate(Visitor* visitor) override;
+};
+
+class Break_stmt : public Directive {
+public:
+  Break_stmt(const Token& token);
+  ~Break_stmt();
+  void evaluate(Visitor* visitor) override;
+};
+
+class Continue_stmt : public Directive {
+public:
+  Continue_stmt(const Token& token);
+  ~Continue_stmt();
+  void evaluate(Visitor* visitor) override;
+};
+
 class Selection : public Directive {
 public:
   Selection(const Token& token, List<Pair<Expression*, Statement*>>* alternatives);
@@ -568,6 +748,23 @@ public:
   void evaluate(Visitor* visitor) override;
 };
 
+class Repetition : public Directive {
+public:
+  Repetition(const Token& token, Expression* expression, Statement* statement);
+  ~Repetition();
+  Expression* const expression;
+  Statement* const statement;
+  void evaluate(Visitor* visitor) override;
+};
+
+class Importation : public Directive {
+public:
+  Importation(const Token& token, Expression* expression);
+  ~Importation();
+  Expression* expression;
+  void evaluate(Visitor* visitor) override;
+};
+
 class Inclusion : public Directive {
 public:
   Inclusion(const Token& token, Expression* expression);
@@ -576,4 +773,13 @@ public:
   void evaluate(Visitor* visitor) override;
 };
 
+class Redirection : public Directive {
+public:
+  Redirection(const Token& token, Expression* expression, Statement* statement);
+  ~Redirection();
+  Expression* const expression;
+  Statement* const statement;
+  void evaluate(Visitor* visitor) override;
+};
+
 #endif // TREE_HPP
@@ -46,22 +46,36 @@ Variant::Variant(bool rhs)
 Variant::Variant(const String& rhs)
 {
   type = Variant::Type::STRING;
-  new (&data.STRING) Shared_ptr<String>();
-  data.STRING = std::make_shared<String>(rhs);
+  new (&data.STRING) Shared_ptr<Variant::Text>();
+  data.STRING = std::make_shared<Variant::Text>(rhs);
 }
 
 Variant::Variant(const Vector<Variant>& rhs)
 {
   type = Variant::Type::ARRAY;
-  new (&data.ARRAY) Shared_ptr<Vector<Variant>>();
-  data.ARRAY = std::make_shared<Vector<Variant>>(rhs);
+  new (&data.ARRAY) Shared_ptr<Variant::Items>();
+  data.ARRAY = std::make_shared<Variant::Items>(rhs);
 }
 
-Variant::Variant(const Map<String, Variant>& rhs)
+Variant::Variant(const Vector<int>& rhs)
+{
+  type = Variant::Type::ARRAY;
+  new (&data.ARRAY) Shared_ptr<Variant::Items>();
+  data.ARRAY = std::make_shared<Variant::Items>(rhs);
+}
+
+Variant::Variant(const Hash_map<String, Variant>& rhs)
 {
   type = Variant::Type::DICTIONARY;
-  new (&data.DICTIONARY) Shared_ptr<Map<String, Variant>>();
-  data.DICTIONARY = std::make_shared<Map<String, Variant>>(rhs);
+  new (&data.DICTIONARY) Shared_ptr<Hash_map<String, Variant>>();
+  data.DICTIONARY = std::make_shared<Hash_map<String, Variant>>(rhs);
+}
+
+Variant::Variant(const Bits& rhs)
+{
+  type = Variant::Type::BITS;
+  new (&data.BITS) Shared_ptr<const Bits>();
+  data.BITS = std::make_shared<const Bits>(rhs);
 }
 
 Variant::Variant(Macro* rhs)
@@ -70,6 +84,35 @@ Variant::Variant(Macro* rhs)
   data.MACRO = rhs;
 }
 
+Variant::Variant(Thunk* rhs)
+{
+  type = Variant::Type::THUNK;
+  data.THUNK = rhs;
+}
+
+// Literals are interned, so that comparing them, and looking them up in dictionaries, needs no hashing nor character compares.
+// Strings too long for in-place appends are left alone, as interned texts must never be mutated.
+Variant Variant::intern(const String& rhs)
+{
+  static Mutex mutex;
+  static Hash_map<String, Shared_ptr<Variant::Text>> pool;
+  if (rhs.size() >= Variant::Text::min_rope_size) {
+    return rhs;
+  }
+  Variant result;
+  result.type = Variant::Type::STRING;
+  new (&result.data.STRING) Shared_ptr<Variant::Text>();
+  Lock_guard lock(mutex);
+  Shared_ptr<Variant::Text>& text = pool[rhs];
+  if (text == nullptr) {
+    text = std::make_shared<Variant::Text>(rhs);
+    text->hash_value = text->hash();
+    text->interned = true;
+  }
+  result.data.STRING = text;
+  return result;
+}
+
 Variant::Variant(const Variant& rhs)
 {
   switch (rhs.type) {
@@ -83,23 +126,32 @@ Variant::Variant(const Variant& rhs)
     break;
   case Variant::Type::STRING:
     type = Variant::Type::STRING;
-    new (&data.STRING) Shared_ptr<String>();
+    new (&data.STRING) Shared_ptr<Variant::Text>();
     data.STRING = rhs.data.STRING;
     break;
   case Variant::Type::ARRAY:
     type = Variant::Type::ARRAY;
-    new (&data.ARRAY) Shared_ptr<Vector<Variant>>();
+    new (&data.ARRAY) Shared_ptr<Variant::Items>();
     data.ARRAY = rhs.data.ARRAY;
     break;
   case Variant::Type::DICTIONARY:
     type = Variant::Type::DICTIONARY;
-    new (&data.DICTIONARY) Shared_ptr<Map<String, Variant>>();
+    new (&data.DICTIONARY) Shared_ptr<Hash_map<String, Variant>>();
     data.DICTIONARY = rhs.data.DICTIONARY;
     break;
+  case Variant::Type::BITS:
+    type = Variant::Type::BITS;
+    new (&data.BITS) Shared_ptr<const Bits>();
+    data.BITS = rhs.data.BITS;
+    break;
   case Variant::Type::MACRO:
     type = Variant::Type::MACRO;
     data.MACRO = rhs.data.MACRO;
     break;
+  case Variant::Type::THUNK:
+    type = Variant::Type::THUNK;
+    data.THUNK = rhs.data.THUNK;
+    break;
   default:
     type = Variant::Type::VOID;
     break;
@@ -118,6 +170,9 @@ Variant::~Variant()
   case Variant::Type::DICTIONARY:
     data.STRING.reset();
     break;
+  case Variant::Type::BITS:
+    data.BITS.reset();
+    break;
   default:
     break;
   }
@@ -151,8 +206,8 @@ Variant& Variant::operator=(const String& rhs)
 {
   this->~Variant();
   type = Variant::Type::STRING;
-  new (&data.STRING) Shared_ptr<String>();
-  data.STRING = std::make_shared<String>(rhs);
+  new (&data.STRING) Shared_ptr<Variant::Text>();
+  data.STRING = std::make_shared<Variant::Text>(rhs);
   return *this;
 }
 
@@ -160,17 +215,17 @@ Variant& Variant::operator=(const Vector<Variant>& rhs)
 {
   this->~Variant();
   type = Variant::Type::ARRAY;
-  new (&data.ARRAY) Shared_ptr<Vector<Variant>>();
-  data.ARRAY = std::make_shared<Vector<Variant>>(rhs);
+  new (&data.ARRAY) Shared_ptr<Variant::Items>();
+  data.ARRAY = std::make_shared<Variant::Items>(rhs);
   return *this;
 }
 
-Variant& Variant::operator=(const Map<String, Variant>& rhs)
+Variant& Variant::operator=(const Hash_map<String, Variant>& rhs)
 {
   this->~Variant();
   type = Variant::Type::DICTIONARY;
-  new (&data.DICTIONARY) Shared_ptr<Map<String, Variant>>();
-  data.DICTIONARY = std::make_shared<Map<String, Variant>>(rhs);
+  new (&data.DICTIONARY) Shared_ptr<Hash_map<String, Variant>>();
+  data.DICTIONARY = std::make_shared<Hash_map<String, Variant>>(rhs);
   return *this;
 }
 
@@ -182,6 +237,14 @@ Variant& Variant::operator=(Macro* rhs)
   return *this;
 }
 
+Variant& Variant::operator=(Thunk* rhs)
+{
+  this->~Variant();
+  type = Variant::Type::THUNK;
+  data.THUNK = rhs;
+  return *this;
+}
+
 Variant& Variant::operator=(const Variant& rhs)
 {
   if (this != &rhs) {
@@ -197,23 +260,32 @@ Variant& Variant::operator=(const Variant& rhs)
       break;
     case Variant::Type::STRING:
       type = Variant::Type::STRING;
-      new (&data.STRING) Shared_ptr<String>();
+      new (&data.STRING) Shared_ptr<Variant::Text>();
       data.STRING = rhs.data.STRING;
       break;
     case Variant::Type::ARRAY:
       type = Variant::Type::ARRAY;
-      new (&data.ARRAY) Shared_ptr<Vector<Variant>>();
+      new (&data.ARRAY) Shared_ptr<Variant::Items>();
       data.ARRAY = rhs.data.ARRAY;
       break;
     case Variant::Type::DICTIONARY:
       type = Variant::Type::DICTIONARY;
-      new (&data.DICTIONARY) Shared_ptr<Map<String, Variant>>();
+      new (&data.DICTIONARY) Shared_ptr<Hash_map<String, Variant>>();
       data.DICTIONARY = rhs.data.DICTIONARY;
       break;
+    case Variant::Type::BITS:
+      type = Variant::Type::BITS;
+      new (&data.BITS) Shared_ptr<const Bits>();
+      data.BITS = rhs.data.BITS;
+      break;
     case Variant::Type::MACRO:
       type = Variant::Type::MACRO;
       data.MACRO = rhs.data.MACRO;
       break;
+    case Variant::Type::THUNK:
+      type = Variant::Type::THUNK;
+      data.THUNK = rhs.data.THUNK;
+      break;
     default:
       type = Variant::Type::VOID;
       break;
@@ -261,7 +333,13 @@ Variant& Variant::operator+=(bool rhs)
 Variant& Variant::operator+=(const String& rhs)
 {
   if (type == Variant::Type::STRING) {
-    *data.STRING += rhs;
+    if (data.STRING->is_flat() && !data.STRING->is_interned()
+      && data.STRING->size() + rhs.size() < Variant::Text::min_rope_size) {
+      data.STRING->append(rhs);
+    }
+    else {
+      data.STRING = Variant::Text::join(data.STRING, std::make_shared<Variant::Text>(rhs));
+    }
     return *this;
   }
   else {
@@ -273,9 +351,7 @@ Variant& Variant::operator+=(const String& rhs)
 Variant& Variant::operator+=(const Vector<Variant>& rhs)
 {
   if (type == Variant::Type::ARRAY) {
-    for (const Variant& item : rhs) {
-      data.ARRAY->push_back(item);
-    }
+    data.ARRAY->append(Variant::Items(rhs));
     return *this;
   }
   else {
@@ -284,10 +360,10 @@ Variant& Variant::operator+=(const Vector<Variant>& rhs)
   }
 }
 
-Variant& Variant::operator+=(const Map<String, Variant>& rhs)
+Variant& Variant::operator+=(const Hash_map<String, Variant>& rhs)
 {
   if (type == Variant::Type::DICTIONARY) {
-    for (const Pair<String, Variant>& item : rhs) {
+    for (const Pair<const String, Variant>& item : rhs) {
       data.DICTIONARY->insert(item);
     }
     return *this;
@@ -321,7 +397,13 @@ Variant& Variant::operator+=(const Variant& rhs)
     }
   case Variant::Type::STRING:
     if (rhs.type == Variant::Type::STRING) {
-      *data.STRING += *rhs.data.STRING;
+      if (data.STRING->is_flat() && !data.STRING->is_interned()
+        && data.STRING->size() + rhs.data.STRING->size() < Variant::Text::min_rope_size) {
+        data.STRING->append(rhs.data.STRING->get_flat());
+      }
+      else {
+        data.STRING = Variant::Text::join(data.STRING, rhs.data.STRING);
+      }
       break;
     }
     else {
@@ -330,9 +412,7 @@ Variant& Variant::operator+=(const Variant& rhs)
     }
   case Variant::Type::ARRAY:
     if (rhs.type == Variant::Type::ARRAY) {
-      for (const Variant& item : *rhs.data.ARRAY) {
-        data.ARRAY->push_back(item);
-      }
+      data.ARRAY->append(*rhs.data.ARRAY);
       break;
     }
     else {
@@ -341,7 +421,7 @@ Variant& Variant::operator+=(const Variant& rhs)
     }
   case Variant::Type::DICTIONARY:
     if (rhs.type == Variant::Type::DICTIONARY) {
-      for (const Pair<String, Variant>& item : *rhs.data.DICTIONARY) {
+      for (const Pair<const String, Variant>& item : *rhs.data.DICTIONARY) {
         data.DICTIONARY->insert(item);
       }
       break;
@@ -360,7 +440,7 @@ Variant& Variant::operator+=(const Variant& rhs)
 Variant& Variant::operator[](int rhs) const
 {
   if (type == Variant::Type::ARRAY) {
-    return data.ARRAY->at(rhs);
+    return data.ARRAY->get_unpacked().at(rhs);
   }
   else {
     String message = "unexpected " + to_string(type) + " on '[]' left-hand side; expecting list or dictionary";
@@ -371,7 +451,7 @@ Variant& Variant::operator[](int rhs) const
 Variant& Variant::operator[](uint rhs) const
 {
   if (type == Variant::Type::ARRAY) {
-    return data.ARRAY->at(rhs);
+    return data.ARRAY->get_unpacked().at(rhs);
   }
   else {
     String message = "unexpected " + to_string(type) + " on '[]' left-hand side; expecting list or dictionary";
@@ -395,7 +475,7 @@ Variant& Variant::operator[](const Variant& rhs) const
   switch (type) {
   case Variant::Type::ARRAY:
     if (rhs.type == Variant::Type::INTEGER) {
-      return data.ARRAY->at(rhs.data.INTEGER);
+      return data.ARRAY->get_unpacked().at(rhs.data.INTEGER);
     }
     else {
       String message = "unexpected " + to_string(rhs.type) + " on '[]' right-hand side; expecting integer";
@@ -403,7 +483,10 @@ Variant& Variant::operator[](const Variant& rhs) const
     }
   case Variant::Type::DICTIONARY:
     if (rhs.type == Variant::Type::STRING) {
-      return data.DICTIONARY->at(*rhs.data.STRING);
+      if (rhs.data.STRING->is_interned()) {
+        return data.DICTIONARY->at(rhs.data.STRING->get_flat(), rhs.data.STRING->hash());
+      }
+      return data.DICTIONARY->at(rhs.data.STRING->get_flat());
     }
     else {
       String message = "unexpected " + to_string(type) + " on '[]' right-hand side; expecting integer or string";
@@ -420,8 +503,11 @@ Variant Variant::operator~() const
   if (type == Variant::Type::INTEGER) {
     return ~data.INTEGER;
   }
+  else if (type == Variant::Type::BITS) {
+    return ~*data.BITS;
+  }
   else {
-    String message = "unexpected " + to_string(type) + " on '~'; expecting integer";
+    String message = "unexpected " + to_string(type) + " on '~'; expecting integer or bit vector";
     throw Bad_variant_access(message);
   }
 }
@@ -451,7 +537,7 @@ Variant Variant::operator+() const
 Variant Variant::operator-() const
 {
   if (type == Variant::Type::INTEGER) {
-    return -data.INTEGER;
+    return subtract(0, data.INTEGER);
   }
   else {
     String message = "unexpected " + to_string(type) + " on '-'; expecting integer";
@@ -461,11 +547,15 @@ Variant Variant::operator-() const
 
 Variant Variant::operator+(Variant rhs) const
 {
+  if ((type == Variant::Type::ARRAY && rhs.type == Variant::Type::INTEGER)
+    || (type == Variant::Type::INTEGER && rhs.type == Variant::Type::ARRAY)) {
+    return elementwise(rhs, "+", add);
+  }
   Variant result;
   switch (type) {
   case Variant::Type::INTEGER:
     if (rhs.type == Variant::Type::INTEGER) {
-      return data.INTEGER + rhs.data.INTEGER;
+      return add(data.INTEGER, rhs.data.INTEGER);
     }
     else {
       String message = "unexpected " + to_string(rhs.type) + " on '+' right-hand side; expecting integer";
@@ -481,8 +571,10 @@ Variant Variant::operator+(Variant rhs) const
     }
   case Variant::Type::STRING:
     if (rhs.type == Variant::Type::STRING) {
-      Variant result(*data.STRING);
-      result += *rhs.data.STRING;
+      Variant result;
+      result.type = Variant::Type::STRING;
+      new (&result.data.STRING) Shared_ptr<Variant::Text>();
+      result.data.STRING = Variant::Text::join(data.STRING, rhs.data.STRING);
       return result;
     }
     else {
@@ -491,8 +583,11 @@ Variant Variant::operator+(Variant rhs) const
     }
   case Variant::Type::ARRAY:
     if (rhs.type == Variant::Type::ARRAY) {
-      Variant result(*data.ARRAY);
-      result += *rhs.data.ARRAY;
+      Variant result;
+      result.type = Variant::Type::ARRAY;
+      new (&result.data.ARRAY) Shared_ptr<Variant::Items>();
+      result.data.ARRAY = std::make_shared<Variant::Items>(*data.ARRAY);
+      result.data.ARRAY->append(*rhs.data.ARRAY);
       return result;
     }
     else {
@@ -517,9 +612,12 @@ Variant Variant::operator+(Variant rhs) const
 
 Variant Variant::operator-(Variant rhs) const
 {
+  if (type == Variant::Type::ARRAY || rhs.type == Variant::Type::ARRAY) {
+    return elementwise(rhs, "-", subtract);
+  }
   if (type == Variant::Type::INTEGER) {
     if (rhs.type == Variant::Type::INTEGER) {
-      return data.INTEGER - rhs.data.INTEGER;
+      return subtract(data.INTEGER, rhs.data.INTEGER);
     }
     else {
       String message = "unexpected " + to_string(rhs.type) + " on '-' right-hand side; expecting integer";
@@ -534,9 +632,12 @@ Variant Variant::operator-(Variant rhs) const
 
 Variant Variant::operator*(Variant rhs) const
 {
+  if (type == Variant::Type::ARRAY || rhs.type == Variant::Type::ARRAY) {
+    return elementwise(rhs, "*", multiply);
+  }
   if (type == Variant::Type::INTEGER) {
     if (rhs.type == Variant::Type::INTEGER) {
-      return data.INTEGER * rhs.data.INTEGER;
+      return multiply(data.INTEGER, rhs.data.INTEGER);
     }
     else {
       String message = "unexpected " + to_string(rhs.type) + " on '*' right-hand side; expecting integer";
@@ -551,9 +652,12 @@ Variant Variant::operator*(Variant rhs) const
 
 Variant Variant::operator/(Variant rhs) const
 {
+  if (type == Variant::Type::ARRAY || rhs.type == Variant::Type::ARRAY) {
+    return elementwise(rhs, "/", divide);
+  }
   if (type == Variant::Type::INTEGER) {
     if (rhs.type == Variant::Type::INTEGER) {
-      return data.INTEGER / rhs.data.INTEGER;
+      return divide(data.INTEGER, rhs.data.INTEGER);
     }
     else {
       String message = "unexpected " + to_string(rhs.type) + " on '/' right-hand side; expecting integer";
@@ -568,9 +672,12 @@ Variant Variant::operator/(Variant rhs) const
 
 Variant Variant::operator%(Variant rhs) const
 {
+  if (type == Variant::Type::ARRAY || rhs.type == Variant::Type::ARRAY) {
+    return elementwise(rhs, "%", modulo);
+  }
   if (type == Variant::Type::INTEGER) {
     if (rhs.type == Variant::Type::INTEGER) {
-      return data.INTEGER % rhs.data.INTEGER;
+      return modulo(data.INTEGER, rhs.data.INTEGER);
     }
     else {
       String message = "unexpected " + to_string(rhs.type) + " on '%' right-hand side; expecting integer";
@@ -585,6 +692,13 @@ Variant Variant::operator%(Variant rhs) const
 
 Variant Variant::operator^(Variant rhs) const
 {
+  if (type == Variant::Type::ARRAY || rhs.type == Variant::Type::ARRAY) {
+    return elementwise(rhs, "^", [](int left, int right) { return left ^ right; });
+  }
+  if (type == Variant::Type::BITS || rhs.type == Variant::Type::BITS) {
+    uint width = type == Variant::Type::BITS ? data.BITS->get_width() : rhs.data.BITS->get_width();
+    return get_bits_operand(width, "^", "left") ^ rhs.get_bits_operand(width, "^", "right");
+  }
   if (type == Variant::Type::INTEGER) {
     if (rhs.type == Variant::Type::INTEGER) {
       return data.INTEGER ^ rhs.data.INTEGER;
@@ -602,6 +716,13 @@ Variant Variant::operator^(Variant rhs) const
 
 Variant Variant::operator&(Variant rhs) const
 {
+  if (type == Variant::Type::ARRAY || rhs.type == Variant::Type::ARRAY) {
+    return elementwise(rhs, "&", [](int left, int right) { return left & right; });
+  }
+  if (type == Variant::Type::BITS || rhs.type == Variant::Type::BITS) {
+    uint width = type == Variant::Type::BITS ? data.BITS->get_width() : rhs.data.BITS->get_width();
+    return get_bits_operand(width, "&", "left") & rhs.get_bits_operand(width, "&", "right");
+  }
   if (type == Variant::Type::INTEGER) {
     if (rhs.type == Variant::Type::INTEGER) {
       return data.INTEGER & rhs.data.INTEGER;
@@ -619,6 +740,13 @@ Variant Variant::operator&(Variant rhs) const
 
 Variant Variant::operator|(Variant rhs) const
 {
+  if (type == Variant::Type::ARRAY || rhs.type == Variant::Type::ARRAY) {
+    return elementwise(rhs, "|", [](int left, int right) { return left | right; });
+  }
+  if (type == Variant::Type::BITS || rhs.type == Variant::Type::BITS) {
+    uint width = type == Variant::Type::BITS ? data.BITS->get_width() : rhs.data.BITS->get_width();
+    return get_bits_operand(width, "|", "left") | rhs.get_bits_operand(width, "|", "right");
+  }
   if (type == Variant::Type::INTEGER) {
     if (rhs.type == Variant::Type::INTEGER) {
       return data.INTEGER | rhs.data.INTEGER;
@@ -670,9 +798,23 @@ Variant Variant::operator>(Variant rhs) const
 
 Variant Variant::operator<<(Variant rhs) const
 {
+  if (type == Variant::Type::ARRAY || rhs.type == Variant::Type::ARRAY) {
+    return elementwise(rhs, "<<", shift_left);
+  }
+  if (type == Variant::Type::BITS) {
+    if (rhs.type != Variant::Type::INTEGER) {
+      String message = "unexpected " + to_string(rhs.type) + " on '<<' right-hand side; expecting integer";
+      throw Bad_variant_access(message);
+    }
+    if (rhs.data.INTEGER < 0) {
+      String message = "shift on '<<' must not be negative";
+      throw Bad_variant_access(message);
+    }
+    return *data.BITS << (uint)rhs.data.INTEGER;
+  }
   if (type == Variant::Type::INTEGER) {
     if (rhs.type == Variant::Type::INTEGER) {
-      return data.INTEGER << rhs.data.INTEGER;
+      return shift_left(data.INTEGER, rhs.data.INTEGER);
     }
     else {
       String message = "unexpected " + to_string(rhs.type) + " on '<<' right-hand side; expecting integer";
@@ -687,9 +829,23 @@ Variant Variant::operator<<(Variant rhs) const
 
 Variant Variant::operator>>(Variant rhs) const
 {
+  if (type == Variant::Type::ARRAY || rhs.type == Variant::Type::ARRAY) {
+    return elementwise(rhs, ">>", shift_right);
+  }
+  if (type == Variant::Type::BITS) {
+    if (rhs.type != Variant::Type::INTEGER) {
+      String message = "unexpected " + to_string(rhs.type) + " on '>>' right-hand side; expecting integer";
+      throw Bad_variant_access(message);
+    }
+    if (rhs.data.INTEGER < 0) {
+      String message = "shift on '>>' must not be negative";
+      throw Bad_variant_access(message);
+    }
+    return *data.BITS >> (uint)rhs.data.INTEGER;
+  }
   if (type == Variant::Type::INTEGER) {
     if (rhs.type == Variant::Type::INTEGER) {
-      return data.INTEGER >> rhs.data.INTEGER;
+      return shift_right(data.INTEGER, rhs.data.INTEGER);
     }
     else {
       String message = "unexpected " + to_string(rhs.type) + " on '>>' right-hand side; expecting integer";
@@ -723,14 +879,22 @@ Variant Variant::operator==(Variant rhs) const
     }
   case Variant::Type::STRING:
     if (rhs.type == Variant::Type::STRING) {
-      return data.STRING == rhs.data.STRING;
+      return data.STRING->is_equal(*rhs.data.STRING);
     }
     else {
       String message = "unexpected " + to_string(type) + " on '==' right-hand side; expecting string";
       throw Bad_variant_access(message);
     }
+  case Variant::Type::BITS:
+    if (rhs.type == Variant::Type::BITS) {
+      return *data.BITS == *rhs.data.BITS;
+    }
+    else {
+      String message = "unexpected " + to_string(rhs.type) + " on '==' right-hand side; expecting bit vector";
+      throw Bad_variant_access(message);
+    }
   default:
-    String message = "unexpected " + to_string(type) + " on '==' left-hand side; expecting integer, boolean or string";
+    String message = "unexpected " + to_string(type) + " on '==' left-hand side; expecting integer, boolean, string or bit vector";
     throw Bad_variant_access(message);
   }
 }
@@ -756,14 +920,22 @@ Variant Variant::operator!=(Variant rhs) const
     }
   case Variant::Type::STRING:
     if (rhs.type == Variant::Type::STRING) {
-      return data.STRING != rhs.data.STRING;
+      return !data.STRING->is_equal(*rhs.data.STRING);
     }
     else {
       String message = "unexpected " + to_string(type) + " on '!=' right-hand side; expecting string";
       throw Bad_variant_access(message);
     }
+  case Variant::Type::BITS:
+    if (rhs.type == Variant::Type::BITS) {
+      return !(*data.BITS == *rhs.data.BITS);
+    }
+    else {
+      String message = "unexpected " + to_string(rhs.type) + " on '!=' right-hand side; expecting bit vector";
+      throw Bad_variant_access(message);
+    }
   default:
-    String message = "unexpected " + to_string(type) + " on '!=' left-hand side; expecting integer, boolean or string";
+    String message = "unexpected " + to_string(type) + " on '!=' left-hand side; expecting integer, boolean, string or bit vector";
     throw Bad_variant_access(message);
   }
 }
@@ -894,6 +1066,151 @@ Variant Variant::clog2()
   return result;
 }
 
+// Formats the value in base 2, 8, 10 or 16, zero-padded to the width in digits. Negative values are formatted as their 32-bit two's
+// complement, except in base 10.
+Variant Variant::to_radix(int base, int width) const
+{
+  String name = base == 2 ? "bin" : base == 8 ? "oct" : base == 10 ? "dec" : "hex";
+  if (type != Variant::Type::INTEGER && type != Variant::Type::BITS) {
+    String message = "unexpected " + to_string(type) + " on '" + name + "'; expecting integer or bit vector";
+    throw Bad_variant_access(message);
+  }
+  if (width < 0) {
+    String message = "width on '" + name + "' must not be negative";
+    throw Bad_variant_access(message);
+  }
+  if (type == Variant::Type::BITS) {
+    String digits = data.BITS->to_string(base);
+    String result;
+    if ((uint)width > digits.size()) {
+      result.append(width - digits.size(), '0');
+    }
+    return result + digits;
+  }
+  bool is_negative = base == 10 && data.INTEGER < 0;
+  uint magnitude = is_negative ? 0u - (uint)data.INTEGER : (uint)data.INTEGER;
+  String result = is_negative ? "-" : "";
+  format_digits(result, magnitude, base, width);
+  return result;
+}
+
+// Formats the value as a Verilog literal of the given width in bits, such as 8'h0f. Negative values are formatted as their two's
+// complement in the width, and values that do not fit in the width are rejected. Digits are zero-padded to the width, except in
+// base 10.
+Variant Variant::to_literal(int width, const String& radix) const
+{
+  int base;
+  int digit_bits;
+  if (radix == "b") {
+    base = 2;
+    digit_bits = 1;
+  }
+  else if (radix == "o") {
+    base = 8;
+    digit_bits = 3;
+  }
+  else if (radix == "d") {
+    base = 10;
+    digit_bits = 0;
+  }
+  else if (radix == "h") {
+    base = 16;
+    digit_bits = 4;
+  }
+  else {
+    String message = "unexpected radix '" + radix + "' on 'sized'; expecting 'b', 'o', 'd' or 'h'";
+    throw Bad_variant_access(message);
+  }
+  if (type != Variant::Type::INTEGER && type != Variant::Type::BITS) {
+    String message = "unexpected " + to_string(type) + " on 'sized'; expecting integer or bit vector";
+    throw Bad_variant_access(message);
+  }
+  if (width <= 0) {
+    String message = "width on 'sized' must be positive";
+    throw Bad_variant_access(message);
+  }
+  if (type == Variant::Type::BITS) {
+    if (!(*data.BITS >> width).is_zero()) {
+      String message = "bit vector on 'sized' does not fit in " + std::to_string(width) + " bit(s)";
+      throw Bad_variant_access(message);
+    }
+    return std::to_string(width) + "'" + radix + data.BITS->resize(width).to_string(base);
+  }
+  if (width > 32) {
+    return std::to_string(width) + "'" + radix + Bits(width, data.INTEGER).to_string(base);
+  }
+  long long value = data.INTEGER;
+  long long limit = 1LL << width;
+  if (value >= limit || value < -(limit / 2)) {
+    String message = "value " + std::to_string(value) + " on 'sized' does not fit in " + std::to_string(width) + " bit(s)";
+    throw Bad_variant_access(message);
+  }
+  uint bits = (uint)(value & (limit - 1));
+  String result = std::to_string(width) + "'" + radix;
+  format_digits(result, bits, base, digit_bits != 0 ? (width + digit_bits - 1) / digit_bits : 0);
+  return result;
+}
+
+// Integers are sign-extended to the width, lists of integers are read as 32-bit chunks from the least significant one, and
+// bit vectors are truncated or extended with zeros.
+Variant Variant::to_bits(int width) const
+{
+  if (width <= 0) {
+    String message = "width on 'bits' must be positive";
+    throw Bad_variant_access(message);
+  }
+  switch (type) {
+  case Variant::Type::INTEGER:
+    return Bits(width, data.INTEGER);
+  case Variant::Type::ARRAY:
+    if (!data.ARRAY->is_packed) {
+      String message = "unexpected list of non-integers on 'bits'; expecting list of integers";
+      throw Bad_variant_access(message);
+    }
+    return Bits(width, data.ARRAY->packed);
+  case Variant::Type::BITS:
+    return data.BITS->resize(width);
+  default:
+    String message = "unexpected " + to_string(type) + " on 'bits'; expecting integer, list of integers or bit vector";
+    throw Bad_variant_access(message);
+  }
+}
+
+// An integer is sliced as a 32-bit vector.
+Variant Variant::slice(int high, int low) const
+{
+  Bits bits(0);
+  if (type == Variant::Type::BITS) {
+    bits = *data.BITS;
+  }
+  else if (type == Variant::Type::INTEGER) {
+    bits = Bits(32, data.INTEGER);
+  }
+  else {
+    String message = "unexpected " + to_string(type) + " on 'slice'; expecting integer or bit vector";
+    throw Bad_variant_access(message);
+  }
+  if (low < 0 || high < low || (uint)high >= bits.get_width()) {
+    String message = "bounds [" + std::to_string(high) + ":" + std::to_string(low) + "] on 'slice' do not fit in "
+      + std::to_string(bits.get_width()) + " bit(s)";
+    throw Bad_variant_access(message);
+  }
+  return bits.slice(high, low);
+}
+
+Variant Variant::concat(const Variant& rhs) const
+{
+  if (type != Variant::Type::BITS) {
+    String message = "unexpected " + to_string(type) + " on 'concat'; expecting bit vector";
+    throw Bad_variant_access(message);
+  }
+  if (rhs.type != Variant::Type::BITS) {
+    String message = "unexpected " + to_string(rhs.type) + " on 'concat'; expecting bit vector";
+    throw Bad_variant_access(message);
+  }
+  return data.BITS->concat(*rhs.data.BITS);
+}
+
 int Variant::get_int() const
 {
   if (type == Variant::Type::INTEGER) {
@@ -919,7 +1236,7 @@ bool Variant::get_bool() const
 String& Variant::get_string() const
 {
   if (type == Variant::Type::STRING) {
-    return *data.STRING;
+    return data.STRING->get_flat();
   }
   else {
     String message = "unexpected " + to_string(type) + " on type conversion; expecting string";
@@ -927,10 +1244,30 @@ String& Variant::get_string() const
   }
 }
 
-Vector<Variant>& Variant::get_array() const
+const Vector<Variant>& Variant::get_array() const
+{
+  if (type == Variant::Type::ARRAY) {
+    return data.ARRAY->get_unpacked();
+  }
+  else {
+    String message = "unexpected " + to_string(type) + " on type conversion; expecting list";
+    throw Bad_variant_access(message);
+  }
+}
+
+// The list must be packed, as told by is_packed.
+const Vector<int>& Variant::get_packed() const
+{
+  return data.ARRAY->packed;
+}
+
+uint Variant::get_length() const
 {
   if (type == Variant::Type::ARRAY) {
-    return *data.ARRAY;
+    return data.ARRAY->size();
+  }
+  else if (type == Variant::Type::BITS) {
+    return data.BITS->get_width();
   }
   else {
     String message = "unexpected " + to_string(type) + " on type conversion; expecting list";
@@ -938,7 +1275,23 @@ Vector<Variant>& Variant::get_array() const
   }
 }
 
-Map<String, Variant>& Variant::get_dictionary() const
+// Copies an item out of a list or dictionary, or a bit out of a bit vector. Unlike '[]', an item of a packed list is read without
+// unpacking the list.
+Variant Variant::get_item(const Variant& rhs) const
+{
+  if (is_packed() && rhs.type == Variant::Type::INTEGER) {
+    return data.ARRAY->packed.at(rhs.data.INTEGER);
+  }
+  if (type == Variant::Type::BITS && rhs.type == Variant::Type::INTEGER) {
+    if (rhs.data.INTEGER < 0 || (uint)rhs.data.INTEGER >= data.BITS->get_width()) {
+      throw Out_of_range("bit index");
+    }
+    return (int)data.BITS->get_bit(rhs.data.INTEGER);
+  }
+  return (*this)[rhs];
+}
+
+Hash_map<String, Variant>& Variant::get_dictionary() const
 {
   if (type == Variant::Type::DICTIONARY) {
     return *data.DICTIONARY;
@@ -949,6 +1302,17 @@ Map<String, Variant>& Variant::get_dictionary() const
   }
 }
 
+const Bits& Variant::get_bits() const
+{
+  if (type == Variant::Type::BITS) {
+    return *data.BITS;
+  }
+  else {
+    String message = "unexpected " + to_string(type) + " on type conversion; expecting bit vector";
+    throw Bad_variant_access(message);
+  }
+}
+
 Macro* Variant::get_macro() const
 {
   if (type == Variant::Type::MACRO) {
@@ -960,6 +1324,488 @@ Macro* Variant::get_macro() const
   }
 }
 
+Thunk* Variant::get_thunk() const
+{
+  if (type == Variant::Type::THUNK) {
+    return data.THUNK;
+  }
+  else {
+    String message = "unexpected " + to_string(type) + " on type conversion; expecting thunk";
+    throw Bad_variant_access(message);
+  }
+}
+
+bool Variant::is_thunk() const
+{
+  return type == Variant::Type::THUNK;
+}
+
+bool Variant::is_int() const
+{
+  return type == Variant::Type::INTEGER;
+}
+
+bool Variant::is_string() const
+{
+  return type == Variant::Type::STRING;
+}
+
+bool Variant::is_array() const
+{
+  return type == Variant::Type::ARRAY;
+}
+
+bool Variant::is_packed() const
+{
+  return type == Variant::Type::ARRAY && data.ARRAY->is_packed;
+}
+
+bool Variant::is_bits() const
+{
+  return type == Variant::Type::BITS;
+}
+
+///////////////////////////////////////////////////////////// HASHING //////////////////////////////////////////////////////////////
+
+#define HASH_COMBINE(seed, value) ((seed) ^ ((value) + 0x9e3779b97f4a7c15ULL + ((seed) << 6) + ((seed) >> 2)))
+
+// Hashes the value by contents, consistently with is_identical.
+size_t Variant::hash() const
+{
+  size_t seed = (size_t)type;
+  switch (type) {
+  case Variant::Type::INTEGER:
+    return HASH_COMBINE(seed, std::hash<int>()(data.INTEGER));
+  case Variant::Type::BOOLEAN:
+    return HASH_COMBINE(seed, std::hash<bool>()(data.BOOLEAN));
+  case Variant::Type::STRING:
+    return HASH_COMBINE(seed, data.STRING->hash());
+  case Variant::Type::ARRAY:
+    if (data.ARRAY->is_packed) {
+      for (int item : data.ARRAY->packed) {
+        seed = HASH_COMBINE(seed, Variant(item).hash());
+      }
+      return seed;
+    }
+    for (const Variant& item : data.ARRAY->get_unpacked()) {
+      seed = HASH_COMBINE(seed, item.hash());
+    }
+    return seed;
+  case Variant::Type::DICTIONARY: {
+    // Items are summed up, so that dictionaries differing only by insertion order hash alike.
+    size_t sum = 0;
+    for (const Pair<const String, Variant>& item : *data.DICTIONARY) {
+      sum += HASH_COMBINE(std::hash<String>()(item.first), item.second.hash());
+    }
+    return HASH_COMBINE(seed, sum);
+  }
+  case Variant::Type::BITS:
+    return HASH_COMBINE(seed, data.BITS->hash());
+  case Variant::Type::MACRO:
+    return HASH_COMBINE(seed, std::hash<Macro*>()(data.MACRO));
+  case Variant::Type::THUNK:
+    return HASH_COMBINE(seed, std::hash<Thunk*>()(data.THUNK));
+  default:
+    return seed;
+  }
+}
+
+// Compares values by type and contents, recursively for lists and dictionaries. Never throws, unlike '=='.
+bool Variant::is_identical(const Variant& rhs) const
+{
+  if (type != rhs.type) {
+    return false;
+  }
+  switch (type) {
+  case Variant::Type::INTEGER:
+    return data.INTEGER == rhs.data.INTEGER;
+  case Variant::Type::BOOLEAN:
+    return data.BOOLEAN == rhs.data.BOOLEAN;
+  case Variant::Type::STRING:
+    return data.STRING->is_equal(*rhs.data.STRING);
+  case Variant::Type::ARRAY:
+    if (data.ARRAY == rhs.data.ARRAY) {
+      return true;
+    }
+    if (data.ARRAY->is_packed && rhs.data.ARRAY->is_packed) {
+      return data.ARRAY->packed == rhs.data.ARRAY->packed;
+    }
+    if (data.ARRAY->size() != rhs.data.ARRAY->size()) {
+      return false;
+    }
+    for (size_t index = 0; index < data.ARRAY->size(); index++) {
+      if (!data.ARRAY->get_unpacked()[index].is_identical(rhs.data.ARRAY->get_unpacked()[index])) {
+        return false;
+      }
+    }
+    return true;
+  case Variant::Type::DICTIONARY: {
+    if (data.DICTIONARY == rhs.data.DICTIONARY) {
+      return true;
+    }
+    if (data.DICTIONARY->size() != rhs.data.DICTIONARY->size()) {
+      return false;
+    }
+    for (const Pair<const String, Variant>& item : *data.DICTIONARY) {
+      Hash_map<String, Variant>::const_iterator rhs_item = rhs.data.DICTIONARY->find(item.first);
+      if (rhs_item == rhs.data.DICTIONARY->end() || !item.second.is_identical(rhs_item->second)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  case Variant::Type::BITS:
+    return data.BITS == rhs.data.BITS || *data.BITS == *rhs.data.BITS;
+  case Variant::Type::MACRO:
+    return data.MACRO == rhs.data.MACRO;
+  case Variant::Type::THUNK:
+    return data.THUNK == rhs.data.THUNK;
+  default:
+    return true;
+  }
+}
+
+// Tests the membership with the index of the list, built on first use; short lists are cheaper to scan. Items of the same type as
+// the value are compared by contents, like in the index, and any other item with '==', which reports the same errors as before.
+bool Variant::contains(const Variant& value) const
+{
+  const uint min_index_size = 16;
+  uint length = get_length();
+  if (length >= min_index_size) {
+    Shared_ptr<const Variant::Index> index = std::atomic_load(&data.ARRAY->index);
+    if (index == nullptr) {
+      if (data.ARRAY->is_packed) {
+        index = std::make_shared<const Variant::Index>(data.ARRAY->packed);
+      }
+      else {
+        index = std::make_shared<const Variant::Index>(data.ARRAY->get_unpacked());
+      }
+      std::atomic_store(&data.ARRAY->index, index);
+    }
+    if (index->type != Variant::Type::VOID && index->type == value.type) {
+      return index->items.count(value) != 0;
+    }
+  }
+  if (data.ARRAY->is_packed && value.type == Variant::Type::INTEGER) {
+    const Vector<int>& packed = data.ARRAY->packed;
+    return std::find(packed.begin(), packed.end(), value.data.INTEGER) != packed.end();
+  }
+  const Vector<Variant>& list = data.ARRAY->get_unpacked();
+  bool is_indexable = value.type == Variant::Type::INTEGER || value.type == Variant::Type::BOOLEAN
+    || value.type == Variant::Type::STRING;
+  for (const Variant& item : list) {
+    if (is_indexable && item.type == value.type) {
+      if (value.is_identical(item)) {
+        return true;
+      }
+    }
+    else {
+      Variant comparison = value == item;
+      if (comparison.get_bool()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+size_t Variant::Hasher::operator()(const Variant& value) const
+{
+  return value.hash();
+}
+
+bool Variant::Identity::operator()(const Variant& lhs, const Variant& rhs) const
+{
+  return lhs.is_identical(rhs);
+}
+
+// Lists of integers only are packed.
+Variant::Items::Items(const Vector<Variant>& rhs)
+  : is_packed(true)
+{
+  for (const Variant& item : rhs) {
+    if (item.type != Variant::Type::INTEGER) {
+      is_packed = false;
+      break;
+    }
+  }
+  if (is_packed) {
+    packed.reserve(rhs.size());
+    for (const Variant& item : rhs) {
+      packed.push_back(item.data.INTEGER);
+    }
+  }
+  else {
+    unpacked = std::make_shared<Vector<Variant>>(rhs);
+  }
+}
+
+Variant::Items::Items(const Vector<int>& rhs)
+  : is_packed(true), packed(rhs)
+{
+}
+
+// The copy owns its items, and builds its index and unpacked variants again if needed.
+Variant::Items::Items(const Items& rhs)
+  : is_packed(rhs.is_packed), packed(rhs.packed)
+{
+  if (!rhs.is_packed) {
+    unpacked = std::make_shared<Vector<Variant>>(*rhs.unpacked);
+  }
+}
+
+uint Variant::Items::size() const
+{
+  return is_packed ? packed.size() : unpacked->size();
+}
+
+// Unpacks the integers into variants on first use. Two threads may unpack at the same time, in which case the first published
+// variants are kept, so that references to them stay valid.
+Vector<Variant>& Variant::Items::get_unpacked()
+{
+  Shared_ptr<Vector<Variant>> result = std::atomic_load(&unpacked);
+  if (result == nullptr) {
+    Shared_ptr<Vector<Variant>> variants = std::make_shared<Vector<Variant>>(packed.begin(), packed.end());
+    if (std::atomic_compare_exchange_strong(&unpacked, &result, variants)) {
+      result = variants;
+    }
+  }
+  return *result;
+}
+
+// Appending integers to packed integers keeps them packed; anything else unpacks the list for good.
+void Variant::Items::append(const Items& rhs)
+{
+  if (&rhs == this) {
+    Items copy(rhs);
+    append(copy);
+    return;
+  }
+  if (is_packed && rhs.is_packed) {
+    packed.insert(packed.end(), rhs.packed.begin(), rhs.packed.end());
+    std::atomic_store(&unpacked, Shared_ptr<Vector<Variant>>());
+  }
+  else {
+    Vector<Variant>& variants = get_unpacked();
+    if (rhs.is_packed) {
+      variants.insert(variants.end(), rhs.packed.begin(), rhs.packed.end());
+    }
+    else {
+      variants.insert(variants.end(), rhs.unpacked->begin(), rhs.unpacked->end());
+    }
+    is_packed = false;
+    packed.clear();
+    packed.shrink_to_fit();
+  }
+  std::atomic_store(&index, Shared_ptr<const Variant::Index>());
+}
+
+Variant::Text::Text(const String& rhs)
+  : length(rhs.size()), flat(std::make_shared<String>(rhs)), head(this), interned(false), hash_value(0)
+{
+}
+
+// The head is the leftmost flat text, kept so that prefixes are read without walking down the rope.
+Variant::Text::Text(const Shared_ptr<Text>& lhs, const Shared_ptr<Text>& rhs)
+  : length(lhs->size() + rhs->size()), left(lhs), right(rhs), head(lhs->head), interned(false), hash_value(0)
+{
+}
+
+// Releases deep ropes iteratively, rather than through nested destructors.
+Variant::Text::~Text()
+{
+  Vector<Shared_ptr<Text>> stack;
+  stack.push_back(std::move(left));
+  stack.push_back(std::move(right));
+  while (!stack.empty()) {
+    Shared_ptr<Text> text = std::move(stack.back());
+    stack.pop_back();
+    if (text != nullptr && text.use_count() == 1) {
+      stack.push_back(std::move(text->left));
+      stack.push_back(std::move(text->right));
+    }
+  }
+}
+
+size_t Variant::Text::size() const
+{
+  return length;
+}
+
+bool Variant::Text::is_flat() const
+{
+  return left == nullptr;
+}
+
+bool Variant::Text::is_interned() const
+{
+  return interned;
+}
+
+bool Variant::Text::is_equal(Text& rhs)
+{
+  if (this == &rhs) {
+    return true;
+  }
+  if (interned && rhs.interned) {
+    return false;
+  }
+  return length == rhs.length && get_flat() == rhs.get_flat();
+}
+
+// Two threads may flatten a rope at the same time, in which case the first published string is kept, so that references to it
+// stay valid.
+String& Variant::Text::get_flat()
+{
+  Shared_ptr<String> result = std::atomic_load(&flat);
+  if (result == nullptr) {
+    Shared_ptr<String> string = std::make_shared<String>();
+    string->reserve(length);
+    write(*string);
+    if (std::atomic_compare_exchange_strong(&flat, &result, string)) {
+      result = string;
+    }
+  }
+  return *result;
+}
+
+// Appends in place to a flat text, which must not be shared yet.
+void Variant::Text::append(const String& rhs)
+{
+  *flat += rhs;
+  length += rhs.size();
+}
+
+// Walks the rope depth first, the left side before the right one, and stops at the texts already flat.
+void Variant::Text::write(String& output)
+{
+  output.reserve(output.size() + length);
+  Vector<Text*> stack(1, this);
+  while (!stack.empty()) {
+    Text* text = stack.back();
+    stack.pop_back();
+    Shared_ptr<String> string = std::atomic_load(&text->flat);
+    if (string != nullptr) {
+      output += *string;
+    }
+    else {
+      stack.push_back(text->right.get());
+      stack.push_back(text->left.get());
+    }
+  }
+}
+
+// Long strings are hashed on their length and edges only, which are read without flattening ropes. Strings differing in their
+// middle only then collide, and are told apart by comparison.
+size_t Variant::Text::hash()
+{
+  if (interned) {
+    return hash_value;
+  }
+  if (length < min_rope_size) {
+    return std::hash<String>()(get_flat());
+  }
+  size_t seed = std::hash<size_t>()(length);
+  seed = HASH_COMBINE(seed, std::hash<String>()(get_prefix(edge_size)));
+  return HASH_COMBINE(seed, std::hash<String>()(get_suffix(edge_size)));
+}
+
+#undef HASH_COMBINE
+
+String Variant::Text::get_prefix(size_t count)
+{
+  String result;
+  Text* text = head->size() >= count ? head : this;
+  count = std::min(count, length);
+  while (count > 0) {
+    Shared_ptr<String> string = std::atomic_load(&text->flat);
+    if (string != nullptr) {
+      result.append(*string, 0, count);
+      break;
+    }
+    if (text->left->size() >= count) {
+      text = text->left.get();
+    }
+    else {
+      text->left->write(result);
+      count -= text->left->size();
+      text = text->right.get();
+    }
+  }
+  return result;
+}
+
+// The texts lying entirely within the suffix are gathered from the right, and written after the partial one.
+String Variant::Text::get_suffix(size_t count)
+{
+  String result;
+  Vector<Text*> tails;
+  Text* text = this;
+  count = std::min(count, length);
+  while (count > 0) {
+    Shared_ptr<String> string = std::atomic_load(&text->flat);
+    if (string != nullptr) {
+      result.append(*string, string->size() - count, count);
+      break;
+    }
+    if (text->right->size() >= count) {
+      text = text->right.get();
+    }
+    else {
+      tails.push_back(text->right.get());
+      count -= text->right->size();
+      text = text->left.get();
+    }
+  }
+  for (uint index = tails.size(); index-- > 0;) {
+    tails[index]->write(result);
+  }
+  return result;
+}
+
+// Short strings are still joined by copy, since a rope would cost more than it saves. Only texts too long to be appended to in
+// place end up shared between strings.
+Shared_ptr<Variant::Text> Variant::Text::join(const Shared_ptr<Text>& lhs, const Shared_ptr<Text>& rhs)
+{
+  if (lhs->size() + rhs->size() < min_rope_size) {
+    return std::make_shared<Text>(lhs->get_flat() + rhs->get_flat());
+  }
+  if (lhs->size() == 0) {
+    return rhs;
+  }
+  if (rhs->size() == 0) {
+    return lhs;
+  }
+  return std::make_shared<Text>(lhs, rhs);
+}
+
+Variant::Index::Index(const Vector<int>& list)
+  : type(Variant::Type::INTEGER)
+{
+  items.reserve(list.size());
+  items.insert(list.begin(), list.end());
+}
+
+Variant::Index::Index(const Vector<Variant>& list)
+  : type(Variant::Type::VOID)
+{
+  if (list.empty()) {
+    return;
+  }
+  Variant::Type first_type = list.front().type;
+  if (first_type != Variant::Type::INTEGER && first_type != Variant::Type::BOOLEAN && first_type != Variant::Type::STRING) {
+    return;
+  }
+  for (const Variant& item : list) {
+    if (item.type != first_type) {
+      return;
+    }
+  }
+  type = first_type;
+  items.reserve(list.size());
+  items.insert(list.begin(), list.end());
+}
+
 ///////////////////////////////////////////////////////////// HANDLERS /////////////////////////////////////////////////////////////
 
 String Variant::to_string() const
@@ -970,7 +1816,9 @@ String Variant::to_string() const
   case Variant::Type::BOOLEAN:
     return std::to_string(data.BOOLEAN);
   case Variant::Type::STRING:
-    return *data.STRING;
+    return data.STRING->get_flat();
+  case Variant::Type::BITS:
+    return std::to_string(data.BITS->get_width()) + "'h" + data.BITS->to_string(16);
   case Variant::Type::VOID:
     return "";
   default:
@@ -979,6 +1827,166 @@ String Variant::to_string() const
   }
 }
 
+// Appends the text of the value, streaming the pieces of a rope without flattening it.
+void Variant::write(String& output) const
+{
+  if (type == Variant::Type::STRING) {
+    data.STRING->write(output);
+  }
+  else {
+    output += to_string();
+  }
+}
+
+void Variant::format_digits(String& text, uint value, int base, int width)
+{
+  char digits[32];
+  char* end = std::to_chars(digits, digits + sizeof(digits), value, base).ptr;
+  int length = end - digits;
+  if (width > length) {
+    text.append(width - length, '0');
+  }
+  text.append(digits, length);
+}
+
+// Applies an integer operation item by item, between two lists of the same length or between a list and an integer. The loops
+// run over the packed buffers only, so that the compiler can vectorize them.
+template <class Operation>
+Variant Variant::elementwise(const Variant& rhs, const String& symbol, Operation operation) const
+{
+  if (type == Variant::Type::ARRAY && rhs.type == Variant::Type::ARRAY) {
+    const Vector<int>& left = get_operand(symbol, "left");
+    const Vector<int>& right = rhs.get_operand(symbol, "right");
+    if (left.size() != right.size()) {
+      String message = "unexpected lists of different sizes on '" + symbol + "'; expecting lists of the same size";
+      throw Bad_variant_access(message);
+    }
+    uint size = left.size();
+    Vector<int> result(size);
+    const int* left_items = left.data();
+    const int* right_items = right.data();
+    int* result_items = result.data();
+    for (uint index = 0; index < size; index++) {
+      result_items[index] = operation(left_items[index], right_items[index]);
+    }
+    return result;
+  }
+  else if (type == Variant::Type::ARRAY) {
+    const Vector<int>& left = get_operand(symbol, "left");
+    if (rhs.type != Variant::Type::INTEGER) {
+      String message = "unexpected " + to_string(rhs.type) + " on '" + symbol + "' right-hand side; expecting integer";
+      throw Bad_variant_access(message);
+    }
+    int right = rhs.data.INTEGER;
+    uint size = left.size();
+    Vector<int> result(size);
+    const int* left_items = left.data();
+    int* result_items = result.data();
+    for (uint index = 0; index < size; index++) {
+      result_items[index] = operation(left_items[index], right);
+    }
+    return result;
+  }
+  else {
+    if (type != Variant::Type::INTEGER) {
+      String message = "unexpected " + to_string(type) + " on '" + symbol + "' left-hand side; expecting integer";
+      throw Bad_variant_access(message);
+    }
+    int left = data.INTEGER;
+    const Vector<int>& right = rhs.get_operand(symbol, "right");
+    uint size = right.size();
+    Vector<int> result(size);
+    const int* right_items = right.data();
+    int* result_items = result.data();
+    for (uint index = 0; index < size; index++) {
+      result_items[index] = operation(left, right_items[index]);
+    }
+    return result;
+  }
+}
+
+// Lists hold integers only when packed.
+const Vector<int>& Variant::get_operand(const String& symbol, const String& side) const
+{
+  if (data.ARRAY->is_packed) {
+    return data.ARRAY->packed;
+  }
+  else {
+    String message = "unexpected list of non-integers on '" + symbol + "' " + side + "-hand side; expecting list of integers";
+    throw Bad_variant_access(message);
+  }
+}
+
+// An integer operand of a bitwise operation is sign-extended to the width of the bit vector on the other side.
+Bits Variant::get_bits_operand(uint width, const String& symbol, const String& side) const
+{
+  if (type == Variant::Type::BITS) {
+    return *data.BITS;
+  }
+  else if (type == Variant::Type::INTEGER) {
+    return Bits(width, data.INTEGER);
+  }
+  else {
+    String message = "unexpected " + to_string(type) + " on '" + symbol + "' " + side
+      + "-hand side; expecting integer or bit vector";
+    throw Bad_variant_access(message);
+  }
+}
+
+// Integer operations wrap around like the hardware they describe, rather than overflow: sums, differences and products are
+// computed on unsigned integers, a zero divisor and a shift wider than an integer are rejected, and the only overflowing
+// quotient, of the smallest integer by minus one, wraps to itself.
+int Variant::add(int left, int right)
+{
+  return (int)((uint)left + (uint)right);
+}
+
+int Variant::subtract(int left, int right)
+{
+  return (int)((uint)left - (uint)right);
+}
+
+int Variant::multiply(int left, int right)
+{
+  return (int)((uint)left * (uint)right);
+}
+
+int Variant::divide(int left, int right)
+{
+  if (right == 0) {
+    String message = "divisor on '/' must not be zero";
+    throw Bad_variant_access(message);
+  }
+  return right == -1 ? (int)(0u - (uint)left) : left / right;
+}
+
+int Variant::modulo(int left, int right)
+{
+  if (right == 0) {
+    String message = "divisor on '%' must not be zero";
+    throw Bad_variant_access(message);
+  }
+  return right == -1 ? 0 : left % right;
+}
+
+int Variant::shift_left(int left, int right)
+{
+  if (right < 0 || right > 31) {
+    String message = "shift on '<<' must be from 0 to 31";
+    throw Bad_variant_access(message);
+  }
+  return (int)((uint)left << right);
+}
+
+int Variant::shift_right(int left, int right)
+{
+  if (right < 0 || right > 31) {
+    String message = "shift on '>>' must be from 0 to 31";
+    throw Bad_variant_access(message);
+  }
+  return left >> right;
+}
+
 String Variant::to_string(Variant::Type type) const
 {
   switch (type) {
@@ -992,8 +2000,12 @@ String Variant::to_string(Variant::Type type) const
     return "list";
   case Variant::Type::DICTIONARY:
     return "dictionary";
+  case Variant::Type::BITS:
+    return "bit vector";
   case Variant::Type::MACRO:
     return "macro";
+  case Variant::Type::THUNK:
+    return "thunk";
   default:
     return "void type";
   }
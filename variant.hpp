@@ -19,10 +19,16 @@
 
 class Variant;
 class Macro;
+class Thunk;
 
+#include <algorithm>
+#include <charconv>
+#include "bits.hpp"
 #include "exception.hpp"
-#include "map.hpp"
+#include "hash_map.hpp"
+#include "hash_set.hpp"
 #include "memory.hpp"
+#include "mutex.hpp"
 #include "string.hpp"
 #include "token.hpp"
 #include "utility.hpp"
@@ -37,16 +43,26 @@ private:
     STRING,
     ARRAY,
     DICTIONARY,
-    MACRO
+    BITS,
+    MACRO,
+    THUNK
   };
 
+  class Text;
+  class Items;
+  class Index;
+  class Hasher;
+  class Identity;
+
   union Data {
     int INTEGER;
     bool BOOLEAN;
-    Shared_ptr<String> STRING;
-    Shared_ptr<Vector<Variant>> ARRAY;
-    Shared_ptr<Map<String, Variant>> DICTIONARY;
+    Shared_ptr<Text> STRING;
+    Shared_ptr<Items> ARRAY;
+    Shared_ptr<Hash_map<String, Variant>> DICTIONARY;
+    Shared_ptr<const Bits> BITS;
     Macro* MACRO;
+    Thunk* THUNK;
 
     Data();
     ~Data();
@@ -56,6 +72,18 @@ private:
   Variant::Data data;
 
   String to_string(Variant::Type type) const;
+  static void format_digits(String& text, uint value, int base, int width);
+  template <class Operation>
+  Variant elementwise(const Variant& rhs, const String& symbol, Operation operation) const;
+  const Vector<int>& get_operand(const String& symbol, const String& side) const;
+  Bits get_bits_operand(uint width, const String& symbol, const String& side) const;
+  static int add(int left, int right);
+  static int subtract(int left, int right);
+  static int multiply(int left, int right);
+  static int divide(int left, int right);
+  static int modulo(int left, int right);
+  static int shift_left(int left, int right);
+  static int shift_right(int left, int right);
 
 public:
   Variant();
@@ -64,18 +92,24 @@ public:
   Variant(bool rhs);
   Variant(const String& rhs);
   Variant(const Vector<Variant>& rhs);
-  Variant(const Map<String, Variant>& rhs);
+  Variant(const Vector<int>& rhs);
+  Variant(const Hash_map<String, Variant>& rhs);
+  Variant(const Bits& rhs);
   Variant(Macro* rhs);
+  Variant(Thunk* rhs);
   Variant(const Variant& rhs);
   ~Variant();
 
+  static Variant intern(const String& rhs);
+
   Variant& operator=(int rhs);
   Variant& operator=(uint rhs);
   Variant& operator=(bool rhs);
   Variant& operator=(const String& rhs);
   Variant& operator=(const Vector<Variant>& rhs);
-  Variant& operator=(const Map<String, Variant>& rhs);
+  Variant& operator=(const Hash_map<String, Variant>& rhs);
   Variant& operator=(Macro* rhs);
+  Variant& operator=(Thunk* rhs);
   Variant& operator=(const Variant& rhs);
 
   Variant& operator+=(int rhs);
@@ -83,7 +117,7 @@ public:
   Variant& operator+=(bool rhs);
   Variant& operator+=(const String& rhs);
   Variant& operator+=(const Vector<Variant>& rhs);
-  Variant& operator+=(const Map<String, Variant>& rhs);
+  Variant& operator+=(const Hash_map<String, Variant>& rhs);
   Variant& operator+=(const Variant& rhs);
 
   Variant& operator[](int rhs) const;
@@ -117,15 +151,116 @@ public:
   Variant pow(const Variant& lhs);
   Variant log2();
   Variant clog2();
+  Variant to_radix(int base, int width) const;
+  Variant to_literal(int width, const String& radix) const;
+  Variant to_bits(int width) const;
+  Variant slice(int high, int low) const;
+  Variant concat(const Variant& rhs) const;
 
   int get_int() const;
   bool get_bool() const;
   String& get_string() const;
-  Vector<Variant>& get_array() const;
-  Map<String, Variant>& get_dictionary() const;
+  const Vector<Variant>& get_array() const;
+  const Vector<int>& get_packed() const;
+  uint get_length() const;
+  Variant get_item(const Variant& rhs) const;
+  Hash_map<String, Variant>& get_dictionary() const;
+  const Bits& get_bits() const;
   Macro* get_macro() const;
+  Thunk* get_thunk() const;
+  bool is_thunk() const;
+  bool is_int() const;
+  bool is_string() const;
+  bool is_array() const;
+  bool is_packed() const;
+  bool is_bits() const;
 
   String to_string() const;
+  void write(String& output) const;
+
+  size_t hash() const;
+  bool is_identical(const Variant& rhs) const;
+  bool contains(const Variant& value) const;
+};
+
+class Variant::Hasher {
+public:
+  size_t operator()(const Variant& value) const;
+};
+
+class Variant::Identity {
+public:
+  bool operator()(const Variant& lhs, const Variant& rhs) const;
+};
+
+// Interned texts are flat, short and unique by contents, and their hash is computed once. Interned strings are thus equal if and
+// only if they share their text; any other string is compared by contents.
+// The text of a string is either flat, or a rope joining two texts, so that long strings are concatenated without being copied.
+// A rope is only flattened when its characters are accessed as a whole, and the flat string is then published atomically, since
+// strings are shared between threads. Ropes are walked iteratively, as strings accumulated piece by piece make them deep.
+class Variant::Text {
+public:
+  Text(const String& rhs);
+  Text(const Shared_ptr<Text>& lhs, const Shared_ptr<Text>& rhs);
+  ~Text();
+
+  size_t size() const;
+  bool is_flat() const;
+  bool is_interned() const;
+  bool is_equal(Text& rhs);
+  String& get_flat();
+  void append(const String& rhs);
+  void write(String& output);
+  size_t hash();
+
+  static Shared_ptr<Text> join(const Shared_ptr<Text>& lhs, const Shared_ptr<Text>& rhs);
+  static const size_t min_rope_size = 1024;
+
+private:
+  static const size_t edge_size = 64;
+
+  size_t length;
+  Shared_ptr<String> flat;
+  Shared_ptr<Text> left;
+  Shared_ptr<Text> right;
+  Text* head;
+  bool interned;
+  size_t hash_value;
+
+  friend Variant Variant::intern(const String& rhs);
+
+  String get_prefix(size_t count);
+  String get_suffix(size_t count);
+};
+
+// The items of a list are packed into a buffer of integers as long as they are all integers, and only unpacked into variants when
+// accessed as such, or once a non-integer is appended. They also keep the hash index built on the first membership test, until
+// they are appended to. Lists are shared between threads, so the unpacked variants and the index are published atomically.
+class Variant::Items {
+public:
+  Items(const Vector<Variant>& rhs);
+  Items(const Vector<int>& rhs);
+  Items(const Items& rhs);
+
+  bool is_packed;
+  Vector<int> packed;
+  Shared_ptr<const Variant::Index> index;
+
+  uint size() const;
+  Vector<Variant>& get_unpacked();
+  void append(const Items& rhs);
+
+private:
+  Shared_ptr<Vector<Variant>> unpacked;
+};
+
+// Only lists of integers, booleans or strings are indexed; the type is void for any other or mixed list.
+class Variant::Index {
+public:
+  Index(const Vector<Variant>& list);
+  Index(const Vector<int>& list);
+  Variant::Type type;
+  Hash_set<Variant, Variant::Hasher, Variant::Identity> items;
 };
 
 class Bad_variant_access : public Exception {
@@ -19,7 +19,8 @@
 /////////////////////////////////////////////////////////////// RUN ////////////////////////////////////////////////////////////////
 
 Visitor::Visitor(Path& file_path, Statement* parse_tree, Environment& environment, Vector<Context>& context_list)
-  : file_path(file_path), parse_tree(parse_tree), environment(environment), context_list(context_list)
+  : file_path(file_path), parse_tree(parse_tree), environment(environment), context_list(context_list),
+    arguments(Arena::get_resource()), sink(nullptr), capture_depth(0), flow(Flow::NEXT)
 {
 }
 
@@ -30,6 +31,22 @@ Visitor::~Visitor()
 String Visitor::visit()
 {
   parse_tree->evaluate(this);
+  check();
+  return output_string;
+}
+
+// Evaluates a single top-level statement of a piped source, and hands the text it generated to the sink right away.
+void Visitor::visit(Statement* statement)
+{
+  statement->evaluate(this);
+  check();
+  flush();
+  sink->flush();
+}
+
+// Throws once the evaluation reported errors, as the generated text is then discarded.
+void Visitor::check()
+{
   uint error_count = environment.get_error_count();
   if (error_count != 0) {
     if (error_count >= 5 && environment.get_call_depth() != 1) {
@@ -39,7 +56,20 @@ String Visitor::visit()
     String message = file_path.string() + ": generation failed due to " + std::to_string(error_count) + " error(s)";
     throw Runtime_error(message);
   }
-  return output_string;
+}
+
+// Writes the text generated so far to the sink, unless it is being captured.
+void Visitor::flush()
+{
+  if (sink != nullptr && capture_depth == 0) {
+    sink->write(output_string.data(), output_string.size());
+    output_string.clear();
+  }
+}
+
+void Visitor::set_sink(Ostream* sink)
+{
+  this->sink = sink;
 }
 
 //////////////////////////////////////////////////////////// STATEMENTS ////////////////////////////////////////////////////////////
@@ -62,6 +92,9 @@ void Visitor::compound(Compound* node)
 {
   for (Statement*& statement : *node->stmt_list) {
     statement->evaluate(this);
+    if (flow != Flow::NEXT) {
+      break;
+    }
   }
 }
 
@@ -70,10 +103,40 @@ void Visitor::plain_text(Plain_text* node)
   output_string.append(node->token.start, node->token.length);
 }
 
+// The span is read back through a window. When streaming, the text generated so far is flushed first to keep the output in order.
+void Visitor::text_span(Text_span* node)
+{
+  try {
+    Ifstream file_in(node->file_path, std::ios::binary);
+    file_in.seekg(node->token.offset);
+    bool is_streaming = sink != nullptr && capture_depth == 0;
+    flush();
+    Vector<char> window(std::min(node->token.length, Stream::window_size));
+    size_t length = node->token.length;
+    while (length != 0) {
+      size_t size = std::min(length, window.size());
+      if (!file_in.read(window.data(), size)) {
+        String message = "cannot read back '" + node->file_path.string() + "'; file changed since compiled";
+        throw Semantic_error(node->token, message);
+      }
+      if (is_streaming) {
+        sink->write(window.data(), size);
+      }
+      else {
+        output_string.append(window.data(), size);
+      }
+      length -= size;
+    }
+  }
+  catch (const Semantic_error& error) {
+    report(error);
+  }
+}
+
 void Visitor::expr_stmt(Expr_stmt* node)
 {
   try {
-    output_string += node->expression->evaluate(this).to_string();
+    node->expression->evaluate(this).write(output_string);
   }
   catch (const Semantic_error& error) {
     report(error);
@@ -84,11 +147,18 @@ void Visitor::expr_stmt(Expr_stmt* node)
   }
 }
 
+// Outside of any local scope, a definition that generates no text is bound lazily to its thunk, and evaluated on first use only.
 void Visitor::global_var_def(Global_var_def* node)
 {
   try {
-    Variant value = node->expression->evaluate(this);
-    node->storage->global_define(this, value);
+    if (node->thunk != nullptr && environment.get_lazy() && !environment.has_locals()) {
+      Variant value = node->thunk;
+      node->storage->global_define(this, value);
+    }
+    else {
+      Variant value = node->expression->evaluate(this);
+      node->storage->global_define(this, value);
+    }
   }
   catch (const Semantic_error& error) {
     report(error);
@@ -129,6 +199,34 @@ void Visitor::printing(Printing* node)
   }
 }
 
+// The macro body is left even if the returned expression fails, so that no more text is generated.
+void Visitor::return_stmt(Return_stmt* node)
+{
+  try {
+    if (node->expression != nullptr) {
+      return_value = node->expression->evaluate(this);
+    }
+  }
+  catch (const Semantic_error& error) {
+    report(error);
+  }
+  catch (const Bad_variant_access& exception) {
+    Semantic_error error(node->token, exception.message);
+    report(error);
+  }
+  flow = Flow::RETURN;
+}
+
+void Visitor::break_stmt(Break_stmt*)
+{
+  flow = Flow::BREAK;
+}
+
+void Visitor::continue_stmt(Continue_stmt*)
+{
+  flow = Flow::CONTINUE;
+}
+
 void Visitor::selection(Selection* node)
 {
   for (Pair<Expression*, Statement*>& alternative : *node->alternatives) {
@@ -146,15 +244,22 @@ void Visitor::iteration(Iteration* node)
 {
   try {
     Variant value_list = node->expression->evaluate(this);
-    const Vector<Variant>& list = value_list.get_array();
-    uint index = 0;
-    for (const Variant& item : list) {
+    uint length = value_list.get_length();
+    for (uint index = 0; index < length; index++) {
+      Variant item = value_list.get_item(index);
       environment.push_block_scope();
       environment.put_local("index", index);
       node->storage->local_define(this, item);
       node->statement->evaluate(this);
       environment.pop_block_scope();
-      index++;
+      if (flow == Flow::RETURN) {
+        break;
+      }
+      else if (flow == Flow::BREAK) {
+        flow = Flow::NEXT;
+        break;
+      }
+      flow = Flow::NEXT;
     }
   }
   catch (const Semantic_error& error) {
@@ -167,6 +272,83 @@ void Visitor::iteration(Iteration* node)
   }
 }
 
+// The pass count is bound to 'index' like in an iteration, and is already visible to the condition evaluated before every pass.
+void Visitor::repetition(Repetition* node)
+{
+  try {
+    for (uint index = 0;; index++) {
+      environment.push_block_scope();
+      environment.put_local("index", index);
+      bool condition;
+      try {
+        condition = node->expression->evaluate(this).get_bool();
+      }
+      catch (...) {
+        environment.pop_block_scope();
+        throw;
+      }
+      if (!condition) {
+        environment.pop_block_scope();
+        break;
+      }
+      node->statement->evaluate(this);
+      environment.pop_block_scope();
+      if (flow == Flow::RETURN) {
+        break;
+      }
+      else if (flow == Flow::BREAK) {
+        flow = Flow::NEXT;
+        break;
+      }
+      flow = Flow::NEXT;
+    }
+  }
+  catch (const Semantic_error& error) {
+    report(error);
+  }
+  catch (const Bad_variant_access& exception) {
+    Semantic_error error(node->token, exception.message);
+    report(error);
+  }
+}
+
+void Visitor::importation(Importation* node)
+{
+  try {
+    Variant value = node->expression->evaluate(this);
+    String incl_file_name = value.get_string();
+    Path incl_file_path(file_path.parent_path());
+    incl_file_path /= incl_file_name;
+    Context* incl_context = search_context(context_list, incl_file_path, incl_file_name);
+    if (incl_context != nullptr && incl_context->acquire() != nullptr) {
+      Shared_ptr<const Module> module;
+      try {
+        module = incl_context->import(context_list);
+      }
+      catch (const Runtime_error& exception) {
+        String message = "failed to import '" + incl_file_path.lexically_normal().string() + "' due to previous error(s)";
+        throw Semantic_error(node->token, message);
+      }
+      if (module == nullptr) {
+        String message = "cannot import '" + incl_file_path.lexically_normal().string() + "'; circular import";
+        throw Semantic_error(node->token, message);
+      }
+      environment.link(module);
+    }
+    else {
+      String message = "cannot import '" + incl_file_path.lexically_normal().string() + "'; file does not exist";
+      throw Semantic_error(node->token, message);
+    }
+  }
+  catch (const Bad_variant_access& exception) {
+    Semantic_error error(node->token, exception.message);
+    report(error);
+  }
+  catch (const Semantic_error& error) {
+    report(error);
+  }
+}
+
 void Visitor::inclusion(Inclusion* node)
 {
   try {
@@ -175,11 +357,9 @@ void Visitor::inclusion(Inclusion* node)
     Path incl_file_path(file_path.parent_path());
     incl_file_path /= incl_file_name;
     Statement* incl_parse_tree = nullptr;
-    for (Context& context : context_list) {
-      if (std::filesystem::equivalent(context.file_path, incl_file_path)) {
-        incl_parse_tree = context.parse_tree;
-        break;
-      }
+    Context* incl_context = search_context(context_list, incl_file_path, incl_file_name);
+    if (incl_context != nullptr) {
+      incl_parse_tree = incl_context->acquire();
     }
     if (incl_parse_tree != nullptr) {
       try {
@@ -208,6 +388,55 @@ void Visitor::inclusion(Inclusion* node)
   }
 }
 
+// The text generated in between is written to the named file, relative to the output directory, instead of the current output.
+// The file is left out if the block has errors.
+void Visitor::redirection(Redirection* node)
+{
+  try {
+    Variant value = node->expression->evaluate(this);
+    String out_file_name = value.get_string();
+    Path out_file_path = environment.get_out_directory() / out_file_name;
+    out_file_path = out_file_path.lexically_normal();
+    String message = "info: generating " + out_file_path.string() + "\n";
+    std::cout << message.data();
+
+    uint error_count = environment.get_error_count();
+    String curr_output;
+    curr_output.swap(output_string);
+    environment.push_block_scope();
+    capture_depth++;
+    try {
+      node->statement->evaluate(this);
+    }
+    catch (...) {
+      capture_depth--;
+      environment.pop_block_scope();
+      output_string.swap(curr_output);
+      throw;
+    }
+    capture_depth--;
+    environment.pop_block_scope();
+    output_string.swap(curr_output);
+
+    if (environment.get_error_count() == error_count) {
+      try {
+        environment.put_output(out_file_path, curr_output);
+      }
+      catch (const Out_of_range& exception) {
+        String message = "cannot output '" + out_file_path.string() + "'; file already generated";
+        throw Semantic_error(node->token, message);
+      }
+    }
+  }
+  catch (const Bad_variant_access& exception) {
+    Semantic_error error(node->token, exception.message);
+    report(error);
+  }
+  catch (const Semantic_error& error) {
+    report(error);
+  }
+}
+
 /////////////////////////////////////////////////////////// EXPRESSIONS ////////////////////////////////////////////////////////////
 
 Variant Visitor::ternary(Ternary* node)
@@ -229,7 +458,11 @@ Variant Visitor::ternary(Ternary* node)
 Variant Visitor::logical_or(Logical_or* node)
 {
   try {
-    return node->left_expr->evaluate(this) || node->right_expr->evaluate(this);
+    Variant left_value = node->left_expr->evaluate(this);
+    if ((left_value || Variant(false)).get_bool()) {
+      return true;
+    }
+    return left_value || node->right_expr->evaluate(this);
   }
   catch (const Bad_variant_access& exception) {
     throw Semantic_error(node->token, exception.message);
@@ -239,7 +472,11 @@ Variant Visitor::logical_or(Logical_or* node)
 Variant Visitor::logical_and(Logical_and* node)
 {
   try {
-    return node->left_expr->evaluate(this) && node->right_expr->evaluate(this);
+    Variant left_value = node->left_expr->evaluate(this);
+    if (!(left_value && Variant(true)).get_bool()) {
+      return false;
+    }
+    return left_value && node->right_expr->evaluate(this);
   }
   catch (const Bad_variant_access& exception) {
     throw Semantic_error(node->token, exception.message);
@@ -341,13 +578,7 @@ Variant Visitor::inside(Inside* node)
   try {
     Variant left_value = node->left_expr->evaluate(this);
     Variant right_val_list = node->right_expr->evaluate(this);
-    for (const Variant& right_value : right_val_list.get_array()) {
-      Variant comparison = left_value == right_value;
-      if (comparison.get_bool()) {
-        return true;
-      }
-    }
-    return false;
+    return right_val_list.contains(left_value);
   }
   catch (const Bad_variant_access& exception) {
     throw Semantic_error(node->token, exception.message);
@@ -479,14 +710,18 @@ Variant Visitor::logical_not(Logical_not* node)
 Variant Visitor::interpolate(Interpolate* node)
 {
   Statement* parse_tree = nullptr;
+  bool is_lazy = environment.get_lazy();
   try {
     Variant value = node->expression->evaluate(this);
     const char* input_stream = value.get_string().data();
     Lexer lexer(input_stream);
     Parser parser(file_path, lexer);
     parse_tree = parser.parse();
+    // The parse tree is deleted below, so no definition may keep a thunk into it.
+    environment.set_lazy(false);
     Visitor visitor(file_path, parse_tree, environment, context_list);
     String output_string = visitor.visit();
+    environment.set_lazy(is_lazy);
     delete parse_tree;
     return output_string;
   }
@@ -494,6 +729,7 @@ Variant Visitor::interpolate(Interpolate* node)
     throw Semantic_error(node->token, exception.message);
   }
   catch (const Runtime_error& error) {
+    environment.set_lazy(is_lazy);
     delete parse_tree;
     String message = "interpolation failed due to previous errors";
     throw Semantic_error(node->token, message);
@@ -522,12 +758,26 @@ Variant Visitor::clog2_bif(Clog2_bif* node)
   }
 }
 
+// A single list argument stands for its items, which are scanned natively when packed.
 Variant Visitor::max_bif(Max_bif* node)
 {
   try {
     Variant result = INT_MIN;
     for (Expression*& expression : *node->expr_list) {
       Variant value = expression->evaluate(this);
+      if (node->expr_list->size() == 1 && value.is_array()) {
+        if (value.is_packed()) {
+          const Vector<int>& packed = value.get_packed();
+          return packed.empty() ? result : Variant(*std::max_element(packed.begin(), packed.end()));
+        }
+        for (const Variant& item : value.get_array()) {
+          Variant comparison = item > result;
+          if (comparison.get_bool()) {
+            result = item;
+          }
+        }
+        return result;
+      }
       Variant comparison = value > result;
       if (comparison.get_bool()) {
         result = value;
@@ -540,12 +790,26 @@ Variant Visitor::max_bif(Max_bif* node)
   }
 }
 
+// A single list argument stands for its items, which are scanned natively when packed.
 Variant Visitor::min_bif(Min_bif* node)
 {
   try {
     Variant result = INT_MAX;
     for (Expression*& expression : *node->expr_list) {
       Variant value = expression->evaluate(this);
+      if (node->expr_list->size() == 1 && value.is_array()) {
+        if (value.is_packed()) {
+          const Vector<int>& packed = value.get_packed();
+          return packed.empty() ? result : Variant(*std::min_element(packed.begin(), packed.end()));
+        }
+        for (const Variant& item : value.get_array()) {
+          Variant comparison = item < result;
+          if (comparison.get_bool()) {
+            result = item;
+          }
+        }
+        return result;
+      }
       Variant comparison = value < result;
       if (comparison.get_bool()) {
         result = value;
@@ -562,7 +826,221 @@ Variant Visitor::size_bif(Size_bif* node)
 {
   try {
     Variant value = node->expression->evaluate(this);
-    return (uint)value.get_array().size();
+    return value.get_length();
+  }
+  catch (const Bad_variant_access& exception) {
+    throw Semantic_error(node->token, exception.message);
+  }
+}
+
+Variant Visitor::join_bif(Join_bif* node)
+{
+  try {
+    Variant value = node->left_expr->evaluate(this);
+    Variant separator = node->right_expr->evaluate(this);
+    const String& separator_string = separator.get_string();
+    String result;
+    bool is_first = true;
+    if (value.is_packed()) {
+      for (int item : value.get_packed()) {
+        if (!is_first) {
+          result += separator_string;
+        }
+        result += std::to_string(item);
+        is_first = false;
+      }
+      return result;
+    }
+    for (const Variant& item : value.get_array()) {
+      if (!is_first) {
+        result += separator_string;
+      }
+      result += item.to_string();
+      is_first = false;
+    }
+    return result;
+  }
+  catch (const Bad_variant_access& exception) {
+    throw Semantic_error(node->token, exception.message);
+  }
+}
+
+// Items are added up with '+', so that lists of strings or lists are concatenated. The sum of an empty list is 0.
+Variant Visitor::sum_bif(Sum_bif* node)
+{
+  try {
+    Variant value = node->expression->evaluate(this);
+    if (value.is_packed()) {
+      int result = 0;
+      for (int item : value.get_packed()) {
+        result += item;
+      }
+      return result;
+    }
+    const Vector<Variant>& list = value.get_array();
+    if (list.empty()) {
+      return 0;
+    }
+    Variant result = list.front();
+    for (uint index = 1; index < list.size(); index++) {
+      result = result + list[index];
+    }
+    return result;
+  }
+  catch (const Bad_variant_access& exception) {
+    throw Semantic_error(node->token, exception.message);
+  }
+}
+
+// Strings are ordered by contents, and any other items with '<', which only orders integers. The sort is stable.
+Variant Visitor::sort_bif(Sort_bif* node)
+{
+  try {
+    Variant value = node->expression->evaluate(this);
+    if (value.is_packed()) {
+      Vector<int> packed = value.get_packed();
+      std::sort(packed.begin(), packed.end());
+      return packed;
+    }
+    Vector<Variant> list = value.get_array();
+    std::stable_sort(list.begin(), list.end(), [](const Variant& lhs, const Variant& rhs) {
+      if (lhs.is_string() && rhs.is_string()) {
+        return lhs.get_string() < rhs.get_string();
+      }
+      return (lhs < rhs).get_bool();
+    });
+    return list;
+  }
+  catch (const Bad_variant_access& exception) {
+    throw Semantic_error(node->token, exception.message);
+  }
+}
+
+Variant Visitor::keys_bif(Keys_bif* node)
+{
+  try {
+    Variant value = node->expression->evaluate(this);
+    const Hash_map<String, Variant>& dictionary = value.get_dictionary();
+    Vector<Variant> list;
+    list.reserve(dictionary.size());
+    for (const Pair<const String, Variant>& item : dictionary) {
+      list.emplace_back(item.first);
+    }
+    return list;
+  }
+  catch (const Bad_variant_access& exception) {
+    throw Semantic_error(node->token, exception.message);
+  }
+}
+
+Variant Visitor::values_bif(Values_bif* node)
+{
+  try {
+    Variant value = node->expression->evaluate(this);
+    const Hash_map<String, Variant>& dictionary = value.get_dictionary();
+    Vector<Variant> list;
+    list.reserve(dictionary.size());
+    for (const Pair<const String, Variant>& item : dictionary) {
+      list.push_back(item.second);
+    }
+    return list;
+  }
+  catch (const Bad_variant_access& exception) {
+    throw Semantic_error(node->token, exception.message);
+  }
+}
+
+Variant Visitor::reverse_bif(Reverse_bif* node)
+{
+  try {
+    Variant value = node->expression->evaluate(this);
+    if (value.is_packed()) {
+      const Vector<int>& packed = value.get_packed();
+      return Vector<int>(packed.rbegin(), packed.rend());
+    }
+    const Vector<Variant>& list = value.get_array();
+    return Vector<Variant>(list.rbegin(), list.rend());
+  }
+  catch (const Bad_variant_access& exception) {
+    throw Semantic_error(node->token, exception.message);
+  }
+}
+
+Variant Visitor::hex_bif(Hex_bif* node)
+{
+  return radix_bif(node->token, node->expr_list, 16);
+}
+
+Variant Visitor::bin_bif(Bin_bif* node)
+{
+  return radix_bif(node->token, node->expr_list, 2);
+}
+
+Variant Visitor::oct_bif(Oct_bif* node)
+{
+  return radix_bif(node->token, node->expr_list, 8);
+}
+
+Variant Visitor::dec_bif(Dec_bif* node)
+{
+  return radix_bif(node->token, node->expr_list, 10);
+}
+
+// The optional third argument is the radix letter of the literal, hexadecimal by default.
+Variant Visitor::sized_bif(Sized_bif* node)
+{
+  try {
+    List<Expression*>::iterator expr_iter = node->expr_list->begin();
+    int width = (*expr_iter++)->evaluate(this).get_int();
+    Variant value = (*expr_iter++)->evaluate(this);
+    String radix = "h";
+    if (expr_iter != node->expr_list->end()) {
+      radix = (*expr_iter)->evaluate(this).get_string();
+    }
+    return value.to_literal(width, radix);
+  }
+  catch (const Bad_variant_access& exception) {
+    throw Semantic_error(node->token, exception.message);
+  }
+}
+
+Variant Visitor::bits_bif(Bits_bif* node)
+{
+  try {
+    int width = node->expr_list->front()->evaluate(this).get_int();
+    Variant value = node->expr_list->back()->evaluate(this);
+    return value.to_bits(width);
+  }
+  catch (const Bad_variant_access& exception) {
+    throw Semantic_error(node->token, exception.message);
+  }
+}
+
+// The bounds are inclusive, the high one first, like a Verilog part-select.
+Variant Visitor::slice_bif(Slice_bif* node)
+{
+  try {
+    List<Expression*>::iterator expr_iter = node->expr_list->begin();
+    Variant value = (*expr_iter++)->evaluate(this);
+    int high = (*expr_iter++)->evaluate(this).get_int();
+    int low = (*expr_iter)->evaluate(this).get_int();
+    return value.slice(high, low);
+  }
+  catch (const Bad_variant_access& exception) {
+    throw Semantic_error(node->token, exception.message);
+  }
+}
+
+// The first argument ends up on the most significant side, like in a Verilog concatenation.
+Variant Visitor::concat_bif(Concat_bif* node)
+{
+  try {
+    List<Expression*>::iterator expr_iter = node->expr_list->begin();
+    Variant result = (*expr_iter++)->evaluate(this);
+    while (expr_iter != node->expr_list->end()) {
+      result = result.concat((*expr_iter++)->evaluate(this));
+    }
+    return result;
   }
   catch (const Bad_variant_access& exception) {
     throw Semantic_error(node->token, exception.message);
@@ -620,19 +1098,53 @@ Variant Visitor::escape_seq(Escape_seq* node)
   }
 }
 
+// Text pieces are appended as variants, without the copy made by to_string(), and long ones are linked into a rope.
 Variant Visitor::quotation(Quotation* node)
 {
+  Shared_ptr<const Variant> value = std::atomic_load(&node->value);
+  if (value != nullptr) {
+    return *value;
+  }
   Variant string = String();
   for (Expression*& expression : *node->expr_list) {
-    string += expression->evaluate(this).to_string();
+    Variant piece = expression->evaluate(this);
+    if (piece.is_string()) {
+      string += piece;
+    }
+    else {
+      string += piece.to_string();
+    }
   }
-  return string;
+  value = std::make_shared<const Variant>(Variant::intern(string.get_string()));
+  std::atomic_store(&node->value, value);
+  return *value;
 }
 
+// Items are gathered into a packed int buffer for as long as every one of them is an int.
 Variant Visitor::array(Array* node)
 {
+  if (node->is_constant) {
+    Shared_ptr<const Variant> value = std::atomic_load(&node->value);
+    if (value != nullptr) {
+      return *value;
+    }
+  }
   try {
+    Vector<int> packed;
     Vector<Variant> list;
+    bool is_packed = true;
+    auto append = [&](const Variant& item) {
+      if (is_packed && item.is_int()) {
+        packed.push_back(item.get_int());
+        return;
+      }
+      if (is_packed) {
+        list.assign(packed.begin(), packed.end());
+        packed.clear();
+        is_packed = false;
+      }
+      list.push_back(item);
+    };
     for (Pair<Expression*, Expression*>& range : *node->range_list) {
       if (range.second != nullptr) {
         int first_value = range.first->evaluate(this).get_int();
@@ -648,14 +1160,19 @@ Variant Visitor::array(Array* node)
           stop_value = second_value - 1;
         }
         for (int value = first_value; value != stop_value; value += step_value) {
-          list.push_back(Variant(value));
+          append(Variant(value));
         }
       }
       else {
-        list.push_back(range.first->evaluate(this));
+        append(range.first->evaluate(this));
       }
     }
-    return list;
+    Variant result = is_packed ? Variant(packed) : Variant(list);
+    if (node->is_constant) {
+      Shared_ptr<const Variant> value = std::make_shared<const Variant>(result);
+      std::atomic_store(&node->value, value);
+    }
+    return result;
   }
   catch (const Bad_variant_access& exception) {
     throw Semantic_error(node->token, exception.message);
@@ -665,7 +1182,7 @@ Variant Visitor::array(Array* node)
 Variant Visitor::dictionary(Dictionary* node)
 {
   try {
-    Map<String, Variant> map;
+    Hash_map<String, Variant> map;
     for (Pair<Expression*, Expression*>& element : *node->elements) {
       Variant key = element.first->evaluate(this);
       Variant value = element.second->evaluate(this);
@@ -684,20 +1201,73 @@ Variant Visitor::macro_call(Macro_call* node)
     Variant base = node->left_expr->evaluate(this);
     Macro* macro = base.get_macro();
     if (node->expr_list->size() == macro->parameters->size()) {
-      List<Pair<Identifier*, Variant>> param_value_list;
-      List<Identifier*>::iterator param_iter = macro->parameters->begin();
+      // Arguments are staged on top of the ones of enclosing calls, and the stage is reused from call to call.
+      uint stage_start = arguments.size();
+      Arena_list<Thunk> thunk_list(Arena::get_resource());
+      List<bool>::iterator lazy_iter = macro->lazy_flags->begin();
       List<Expression*>::iterator expr_iter = node->expr_list->begin();
-      for (; param_iter != macro->parameters->end(); param_iter++, expr_iter++) {
-        Variant value = (*expr_iter)->evaluate(this);
-        param_value_list.push_back(Pair<Identifier*, Variant>(*param_iter, value));
+      try {
+        for (; expr_iter != node->expr_list->end(); lazy_iter++, expr_iter++) {
+          if (*lazy_iter) {
+            thunk_list.emplace_back(file_path, *expr_iter, environment.get_scope_depth());
+            arguments.emplace_back(&thunk_list.back());
+          }
+          else {
+            arguments.push_back((*expr_iter)->evaluate(this));
+          }
+        }
+      }
+      catch (...) {
+        arguments.resize(stage_start);
+        throw;
+      }
+      // A pure macro emits the same text for the same arguments, so a cached text is replayed instead of the body.
+      uint count = arguments.size() - stage_start;
+      if (macro->memo != nullptr) {
+        String text;
+        Variant result;
+        if (macro->memo->find(arguments.data() + stage_start, count, text, result)) {
+          output_string += text;
+          arguments.resize(stage_start);
+          return result;
+        }
       }
       environment.push_func_scope(macro->file_path, node->token);
-      for (Pair<Identifier*, Variant>& param_value : param_value_list) {
-        param_value.first->local_define(this, param_value.second);
+      try {
+        uint index = stage_start;
+        for (Identifier* parameter : *macro->parameters) {
+          parameter->local_define(this, arguments[index]);
+          index++;
+        }
+      }
+      catch (...) {
+        arguments.resize(stage_start);
+        environment.pop_func_scope();
+        throw;
+      }
+      Arena_vector<Variant> memo_args(Arena::get_resource());
+      if (macro->memo != nullptr) {
+        memo_args.assign(arguments.begin() + stage_start, arguments.end());
+      }
+      arguments.resize(stage_start);
+      size_t text_start = output_string.size();
+      uint error_count = environment.get_error_count();
+      if (macro->memo != nullptr) {
+        capture_depth++;
       }
-      Variant result;
       macro->statement->evaluate(this);
+      if (macro->memo != nullptr) {
+        capture_depth--;
+      }
       environment.pop_func_scope();
+      Variant result;
+      if (flow == Flow::RETURN) {
+        std::swap(result, return_value);
+        flow = Flow::NEXT;
+      }
+      if (macro->memo != nullptr && environment.get_error_count() == error_count) {
+        macro->memo->insert(memo_args.data(), count, output_string.substr(text_start), result);
+      }
       return result;
     }
     else {
@@ -715,7 +1285,7 @@ Variant Visitor::eval_identifier(Identifier* node)
 {
   String key = node->token.get_text();
   try {
-    return environment.get(key);
+    return lookup(node->token, key);
   }
   catch (const Out_of_range& error) {
     String message = "cannot find '" + key + "'; identifier undefined";
@@ -729,7 +1299,7 @@ Variant Visitor::eval_subscript(Subscript* node)
     String key = node->token.get_text();
     Variant left_value = node->left_expr->evaluate(this);
     Variant right_value = node->right_expr->evaluate(this);
-    return left_value[right_value];
+    return left_value.get_item(right_value);
   }
   catch (const Out_of_range& error) {
     String message = "index is out of range";
@@ -746,7 +1316,7 @@ Variant Visitor::eval_indirection(Indirection* node)
   String key;
   try {
     key = name.get_string();
-    return environment.get(key);
+    return lookup(node->token, key);
   }
   catch (const Out_of_range& error) {
     String message = "cannot find '" + key + "'; identifier undefined";
@@ -759,11 +1329,11 @@ Variant Visitor::eval_indirection(Indirection* node)
 
 /////////////////////////////////////////////////////// LOCATIONS REFERENCE ////////////////////////////////////////////////////////
 
-Variant& Visitor::ref_identifier(Identifier* node)
+const Variant& Visitor::ref_identifier(Identifier* node)
 {
   String key = node->token.get_text();
   try {
-    return environment.get(key);
+    return lookup(node->token, key);
   }
   catch (const Out_of_range& error) {
     String message = "cannot find '" + key + "'; identifier undefined";
@@ -771,12 +1341,12 @@ Variant& Visitor::ref_identifier(Identifier* node)
   }
 }
 
-Variant& Visitor::ref_subscript(Subscript* node)
+const Variant& Visitor::ref_subscript(Subscript* node)
 {
   String key = node->token.get_text();
   try {
     Location* left_location = (Location*)node->left_expr;
-    Variant& left_value = left_location->reference(this);
+    const Variant& left_value = left_location->reference(this);
     Variant right_value = node->right_expr->evaluate(this);
     return left_value[right_value];
   }
@@ -789,13 +1359,13 @@ Variant& Visitor::ref_subscript(Subscript* node)
   }
 }
 
-Variant& Visitor::ref_indirection(Indirection* node)
+const Variant& Visitor::ref_indirection(Indirection* node)
 {
   Variant name = node->expression->evaluate(this);
   String key;
   try {
     key = name.get_string();
-    return environment.get(key);
+    return lookup(node->token, key);
   }
   catch (const Out_of_range& error) {
     String message = "cannot find '" + key + "'; identifier undefined";
@@ -868,6 +1438,64 @@ void Visitor::local_ind_def(Indirection* node, const Variant& value)
 
 ///////////////////////////////////////////////////////////// HANDLES //////////////////////////////////////////////////////////////
 
+// The optional second argument is the minimum count of digits, padded with zeros.
+Variant Visitor::radix_bif(const Token& token, List<Expression*>* expr_list, int base)
+{
+  try {
+    List<Expression*>::iterator expr_iter = expr_list->begin();
+    Variant value = (*expr_iter++)->evaluate(this);
+    int width = 0;
+    if (expr_iter != expr_list->end()) {
+      width = (*expr_iter)->evaluate(this).get_int();
+    }
+    return value.to_radix(base, width);
+  }
+  catch (const Bad_variant_access& exception) {
+    throw Semantic_error(token, exception.message);
+  }
+}
+
+// Lazy globals and lazy macro arguments are evaluated on first use in the scope they were bound in, and replaced by their value.
+// Errors are reported as if raised at the binding, called from that first use, and the text generated by a lazy argument is
+// emitted at that first use.
+const Variant& Visitor::lookup(const Token& token, const String& key)
+{
+  const Variant& value = environment.get(key);
+  if (!value.is_thunk()) {
+    return value;
+  }
+  Thunk* thunk = value.get_thunk();
+  try {
+    environment.push_thunk_scope(thunk->file_path, token, thunk, thunk->scope_depth, environment.get_global_limit(key));
+  }
+  catch (const Out_of_range& error) {
+    String message = "cannot evaluate '" + key + "'; circular definition";
+    throw Semantic_error(token, message);
+  }
+  uint error_count = environment.get_error_count();
+  Visitor visitor(thunk->file_path, nullptr, environment, context_list);
+  Variant result;
+  try {
+    result = thunk->expression->evaluate(&visitor);
+  }
+  catch (const Semantic_error& error) {
+    report(error);
+  }
+  catch (const Bad_variant_access& exception) {
+    Semantic_error error(thunk->expression->token, exception.message);
+    report(error);
+  }
+  environment.pop_thunk_scope();
+  if (environment.get_error_count() != error_count) {
+    environment.erase(key);
+    String message = "cannot evaluate '" + key + "' due to previous error(s)";
+    throw Semantic_error(token, message);
+  }
+  output_string += visitor.output_string;
+  environment.set(key, result);
+  return environment.get(key);
+}
+
 void Visitor::report(const Semantic_error& error)
 {
   environment.report(error);
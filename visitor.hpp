@@ -20,10 +20,12 @@
 class Visitor;
 
 #include <climits>
+#include "arena.hpp"
 #include "context.hpp"
 #include "environment.hpp"
 #include "exception.hpp"
 #include "filesystem.hpp"
+#include "fstream.hpp"
 #include "lexer.hpp"
 #include "parser.hpp"
 #include "string.hpp"
@@ -44,21 +46,46 @@ private:
   Vector<Context>& context_list;
 
   String output_string;
+  Arena_vector<Variant> arguments;
+
+  // Streamed text is written straight to the sink, unless the output is being captured by a redirection or a memo.
+  Ostream* sink;
+  uint capture_depth;
+
+  // The flow tells whether the statements left in the current loop body or macro body are skipped, and the returned value is
+  // held meanwhile.
+  enum class Flow {
+    NEXT,
+    BREAK,
+    CONTINUE,
+    RETURN
+  };
+  Flow flow;
+  Variant return_value;
 
 public:
   String visit();
+  void visit(Statement* statement);
+  void set_sink(Ostream* sink);
 
   void assertion(Assertion* node);
   void compound(Compound* node);
   void plain_text(Plain_text* node);
+  void text_span(Text_span* node);
   void expr_stmt(Expr_stmt* node);
   void local_var_def(Local_var_def* node);
   void global_var_def(Global_var_def* node);
   void macro_def(Macro_def* node);
   void printing(Printing* node);
+  void return_stmt(Return_stmt* node);
+  void break_stmt(Break_stmt* node);
+  void continue_stmt(Continue_stmt* node);
   void selection(Selection* node);
   void iteration(Iteration* node);
+  void repetition(Repetition* node);
+  void importation(Importation* node);
   void inclusion(Inclusion* node);
+  void redirection(Redirection* node);
 
   Variant ternary(Ternary* node);
   Variant logical_or(Logical_or* node);
@@ -91,6 +118,20 @@ public:
   Variant max_bif(Max_bif* node);
   Variant min_bif(Min_bif* node);
   Variant size_bif(Size_bif* node);
+  Variant join_bif(Join_bif* node);
+  Variant sum_bif(Sum_bif* node);
+  Variant sort_bif(Sort_bif* node);
+  Variant keys_bif(Keys_bif* node);
+  Variant values_bif(Values_bif* node);
+  Variant reverse_bif(Reverse_bif* node);
+  Variant hex_bif(Hex_bif* node);
+  Variant bin_bif(Bin_bif* node);
+  Variant oct_bif(Oct_bif* node);
+  Variant dec_bif(Dec_bif* node);
+  Variant sized_bif(Sized_bif* node);
+  Variant bits_bif(Bits_bif* node);
+  Variant slice_bif(Slice_bif* node);
+  Variant concat_bif(Concat_bif* node);
   Variant integer(Integer* node);
   Variant true_const(True_const* node);
   Variant false_const(False_const* node);
@@ -104,9 +145,9 @@ public:
   Variant eval_identifier(Identifier* node);
   Variant eval_indirection(Indirection* node);
 
-  Variant& ref_subscript(Subscript* node);
-  Variant& ref_identifier(Identifier* node);
-  Variant& ref_indirection(Indirection* node);
+  const Variant& ref_subscript(Subscript* node);
+  const Variant& ref_identifier(Identifier* node);
+  const Variant& ref_indirection(Indirection* node);
 
   void global_id_def(Identifier* node, const Variant& value);
   void local_id_def(Identifier* node, const Variant& value);
@@ -114,7 +155,11 @@ public:
   void local_ind_def(Indirection* node, const Variant& value);
 
 private:
+  const Variant& lookup(const Token& token, const String& key);
+  Variant radix_bif(const Token& token, List<Expression*>* expr_list, int base);
   void report(const Semantic_error& error);
+  void check();
+  void flush();
 };
 
 #endif // VISITOR_HPP
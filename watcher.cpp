@@ -0,0 +1,129 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "watcher.hpp"
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+// Editors either rewrite files in place or save them aside and rename them over the original, which drops any watch put on the
+// file itself. The parent directories are watched instead, and events are filtered against the known contexts.
+#define WATCH_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO)
+
+// Saving several files at once raises a burst of events; they are gathered until the directory stays quiet for that long.
+#define SETTLE_DELAY 100
+
+Watcher::Watcher(Vector<Context>& context_list, const Path& out_directory, const Hash_map<String, Variant>& globals)
+  : context_list(context_list), out_directory(out_directory), globals(globals)
+{
+  inotify_fd = inotify_init1(IN_CLOEXEC);
+  if (inotify_fd < 0) {
+    String message = "error: cannot initialize file watcher";
+    throw Runtime_error(message);
+  }
+  Set<Path> directory_list;
+  for (Context& context : context_list) {
+    directory_list.insert(context.file_path.parent_path());
+  }
+  for (const Path& directory : directory_list) {
+    int watch_fd = inotify_add_watch(inotify_fd, directory.c_str(), WATCH_EVENTS);
+    if (watch_fd < 0) {
+      String message = "warning: cannot watch " + directory.string() + "\n";
+      std::cout << message.data();
+      continue;
+    }
+    watch_list.insert(Pair<int, Path>(watch_fd, directory));
+  }
+}
+
+Watcher::~Watcher()
+{
+  close(inotify_fd);
+}
+
+void Watcher::run()
+{
+  String message = "info: watching " + std::to_string(context_list.size()) + " file(s)\n";
+  std::cout << message.data();
+  for (;;) {
+    Set<Path> file_list = wait();
+    if (!file_list.empty()) {
+      update(file_list);
+    }
+  }
+}
+
+// Blocks until at least one event is received, then drains the queue until it settles. Returns the changed known files.
+Set<Path> Watcher::wait()
+{
+  Set<Path> file_list;
+  alignas(struct inotify_event) char buffer[4096];
+  pollfd poll_fd = { inotify_fd, POLLIN, 0 };
+  int timeout = -1;
+  while (poll(&poll_fd, 1, timeout) > 0) {
+    ssize_t length = read(inotify_fd, buffer, sizeof(buffer));
+    for (ssize_t offset = 0; offset < length;) {
+      const struct inotify_event* event = (const struct inotify_event*)(buffer + offset);
+      offset += sizeof(struct inotify_event) + event->len;
+      Map<int, Path>::iterator watch = watch_list.find(event->wd);
+      if (watch != watch_list.end() && event->len != 0) {
+        Path file_path = watch->second / event->name;
+        for (Context& context : context_list) {
+          if (context.file_path == file_path) {
+            file_list.insert(file_path);
+            break;
+          }
+        }
+      }
+    }
+    timeout = SETTLE_DELAY;
+  }
+  return file_list;
+}
+
+// Recompiles the changed files, then regenerates every source that is either changed or includes a changed file, even indirectly.
+void Watcher::update(const Set<Path>& file_list)
+{
+  for (Context& context : context_list) {
+    if (file_list.count(context.file_path) != 0) {
+      try {
+        context.compile();
+      }
+      catch (const Exception& exception) {
+        std::cerr << exception.what() << std::endl;
+      }
+    }
+  }
+  for (Context& context : context_list) {
+    bool is_outdated = file_list.count(context.file_path) != 0;
+    for (const Path& file_path : file_list) {
+      is_outdated = is_outdated || context.inclusions.count(file_path) != 0;
+    }
+    if (is_outdated) {
+      try {
+        context.generate(context_list, context.get_out_file_path(out_directory), globals);
+      }
+      catch (const Exception& exception) {
+        std::cerr << exception.what() << std::endl;
+      }
+    }
+  }
+  std::cout << "info: finished\n";
+}
+
+#undef WATCH_EVENTS
+#undef SETTLE_DELAY
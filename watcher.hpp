@@ -0,0 +1,54 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef WATCHER_HPP
+#define WATCHER_HPP
+
+#include <iostream>
+
+class Watcher;
+
+#include "context.hpp"
+#include "exception.hpp"
+#include "filesystem.hpp"
+#include "hash_map.hpp"
+#include "map.hpp"
+#include "set.hpp"
+#include "string.hpp"
+#include "utility.hpp"
+#include "variant.hpp"
+#include "vector.hpp"
+
+class Watcher {
+public:
+  Watcher(Vector<Context>& context_list, const Path& out_directory, const Hash_map<String, Variant>& globals);
+  ~Watcher();
+
+  void run();
+
+private:
+  Vector<Context>& context_list;
+  const Path& out_directory;
+  const Hash_map<String, Variant>& globals;
+
+  int inotify_fd;
+  Map<int, Path> watch_list;
+
+  Set<Path> wait();
+  void update(const Set<Path>& file_list);
+};
+
+#endif // WATCHER_HPP
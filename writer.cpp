@@ -0,0 +1,85 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "writer.hpp"
+
+Writer::Writer()
+  : is_closed(false)
+{
+  thread = Thread(&Writer::run, this);
+}
+
+Writer::~Writer()
+{
+  if (thread.joinable()) {
+    {
+      Lock_guard lock(mutex);
+      is_closed = true;
+    }
+    condition.notify_one();
+    thread.join();
+  }
+}
+
+// The text is moved into the queue, and the given string is left empty.
+void Writer::write(const Path& file_path, String& text)
+{
+  {
+    Lock_guard lock(mutex);
+    queue.emplace_back(file_path, String());
+    queue.back().second.swap(text);
+  }
+  condition.notify_one();
+}
+
+void Writer::close()
+{
+  {
+    Lock_guard lock(mutex);
+    is_closed = true;
+  }
+  condition.notify_one();
+  thread.join();
+  if (!errors.empty()) {
+    errors.pop_back();
+    throw Runtime_error(errors);
+  }
+}
+
+void Writer::run()
+{
+  for (;;) {
+    Pair<Path, String> file;
+    {
+      Unique_lock lock(mutex);
+      condition.wait(lock, [this] { return !queue.empty() || is_closed; });
+      if (queue.empty()) {
+        return;
+      }
+      file.first = queue.front().first;
+      file.second.swap(queue.front().second);
+      queue.pop_front();
+    }
+    Ofstream file_out(file.first);
+    if (file_out.is_open()) {
+      file_out << file.second.data();
+      file_out.close();
+    }
+    else {
+      errors += "error: cannot create " + file.first.string() + "\n";
+    }
+  }
+}
@@ -0,0 +1,54 @@
+// Copyright (C) 2020-2021, Hugo Decharnes. All rights reserved.
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// Lesser General Public License for more details.
+// 
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef WRITER_HPP
+#define WRITER_HPP
+
+#include <iostream>
+
+class Writer;
+
+#include "exception.hpp"
+#include "filesystem.hpp"
+#include "fstream.hpp"
+#include "list.hpp"
+#include "mutex.hpp"
+#include "string.hpp"
+#include "thread.hpp"
+#include "utility.hpp"
+
+// A writer hands generated files off to a background thread, so that evaluation goes on while previous files are written.
+// Closing the writer waits for every pending file, and throws a runtime error listing the files that could not be created.
+class Writer {
+public:
+  Writer();
+  ~Writer();
+
+  void write(const Path& file_path, String& text);
+  void close();
+
+private:
+  Thread thread;
+  Mutex mutex;
+  Condition_variable condition;
+  List<Pair<Path, String>> queue;
+  bool is_closed;
+  String errors;
+
+  void run();
+};
+
+#endif // WRITER_HPP